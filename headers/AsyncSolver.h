@@ -0,0 +1,134 @@
+#pragma once
+
+#include "MethodFactory.h"
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/Misc.h"
+#include "util/NFunction.h"
+#include "util/SolveBudget.h"
+#include "util/ThreadPool.h"
+#include "util/Vector.h"
+
+#include <functional>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define ND_MINIMIZATION_HAS_COROUTINES 1
+#endif
+
+namespace min_nd {
+
+/*
+ * Self-contained description of one search: it owns everything the search needs,
+ * so it can be solved on any thread. The function is shared with other requests, not copied.
+ */
+struct SolveRequest
+{
+    util::NFunctionHandle func;
+    std::string method;               // name of n-dimensional method (see MethodFactory.h)
+    std::string sd_method = "golden"; // name of one dimensional method
+    double eps = 1e-6;
+    std::optional<util::Vector> start;
+    std::optional<util::SolveBudget> budget; // default budget of the method if not set
+    MethodOptions options{};                 // its pool must not be the executor of the solver
+};
+
+using SolveResult = util::ErrorOr<SearchRes>;
+using SolveCallback = std::function<void(const SolveResult &)>;
+
+/*
+ * Answer of a portfolio of methods (see AsyncSolver::submit_portfolio).
+ */
+struct PortfolioResult
+{
+    SolveResult result;
+    std::string method; // the method, which found the result
+};
+
+/*
+ * Solve request on the calling thread with freshly created methods.
+ */
+SolveResult solve(const SolveRequest & request);
+
+#ifdef ND_MINIMIZATION_HAS_COROUTINES
+struct AsyncSolver;
+
+/*
+ * co_await-able search: the coroutine is suspended while the request is solved on the executor
+ * and is resumed on the executor's thread.
+ */
+struct SolveAwaitable
+{
+    SolveAwaitable(AsyncSolver & solver, SolveRequest request)
+        : m_solver(solver)
+        , m_request(std::move(request))
+    {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    SolveResult await_resume() { return std::move(*m_result); }
+
+private:
+    AsyncSolver & m_solver;
+    SolveRequest m_request;
+    std::optional<SolveResult> m_result;
+};
+#endif
+
+/*
+ * Executor for searches: requests are solved on an internal pool of threads,
+ * so submitting threads are never blocked. Pending requests are finished on destruction.
+ */
+struct AsyncSolver
+{
+    explicit AsyncSolver(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : m_pool(threads)
+    {}
+
+    std::future<SolveResult> submit(SolveRequest request);
+    /*
+     * on_done is called on the executor's thread before the future becomes ready.
+     */
+    std::future<SolveResult> submit(SolveRequest request, SolveCallback on_done);
+
+    /*
+     * Submit several requests at once; futures are in the order of requests.
+     */
+    std::vector<std::future<SolveResult>> submit_all(std::vector<SolveRequest> requests);
+    /*
+     * on_done(idx, result) is called for each request as soon as it is solved.
+     */
+    void submit_all(std::vector<SolveRequest> requests, std::function<void(std::size_t, const SolveResult &)> on_done);
+
+    /*
+     * Race the methods on the request's function, request.method is ignored.
+     * Each method solves the request as a separate task, all of them share the function.
+     * The first converged result with finite minimum and residual within request.eps is the answer,
+     * and the other searches are cancelled: they stop on their next iteration.
+     * If none is such, the answer is the least finite minimum found, or the first error, if all of them failed.
+     * Methods race in parallel as far as the executor has free threads.
+     * Token of request's budget, if any, cancels all of them.
+     */
+    std::future<PortfolioResult> submit_portfolio(SolveRequest request, std::vector<std::string> methods);
+
+#ifdef ND_MINIMIZATION_HAS_COROUTINES
+    SolveAwaitable solve_async(SolveRequest request) { return {*this, std::move(request)}; }
+#endif
+
+    std::size_t threads() const noexcept { return m_pool.size(); }
+
+private:
+#ifdef ND_MINIMIZATION_HAS_COROUTINES
+    friend struct SolveAwaitable;
+#endif
+
+    util::ThreadPool m_pool;
+};
+
+} // namespace min_nd
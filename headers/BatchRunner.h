@@ -0,0 +1,93 @@
+#pragma once
+
+#include "util/BufferedWriter.h"
+#include "util/Json.h"
+#include "util/Misc.h"
+#include "util/NFunction.h"
+#include "util/ThreadPool.h"
+#include "util/Vector.h"
+
+#include <deque>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace min_nd {
+
+/*
+ * One line of batch input, for example:
+ * {"id": 7, "problem": "p.bin", "method": "fastest-descent", "sd_method": "brent", "eps": 1e-6, "start": [1, 2], "with_point": true,
+ *  "max_iter": 500, "max_evals": 10000, "timeout_ms": 50, "profile": true, "replay": "trace.bin",
+ *  "parallel": 4}
+ * Only "problem" and "method" are required.
+ */
+struct BatchJob
+{
+    util::JsonValue id;              // echoed back in the result as is
+    std::string problem;             // path to problem file (see util/ProblemFile.h)
+    std::string method;              // name of n-dimensional method (see MethodFactory.h)
+    std::string sd_method = "golden"; // name of one dimensional method
+    double eps = 1e-6;               // required precision
+    std::optional<util::Vector> start; // zero if not set
+    bool with_point = false;         // whether to output the found point
+    bool profile = false;            // whether to output hardware counters by phases (see util/PerfCounters.h)
+    std::string replay;              // if set, the search is traced and its replay data is saved there (see util/ReplayColumns.h)
+    std::optional<double> max_iter;  // limits of the search, see util/SolveBudget.h
+    std::optional<double> max_evals;
+    std::optional<double> timeout_ms;
+    uint parallel = 1;               // vertices of nelder-mead moved on each iteration (see MethodFactory.h)
+};
+
+util::ErrorOr<BatchJob> parse_batch_job(std::string_view line);
+
+struct BatchOptions
+{
+    std::size_t threads = 1;       // number of worker threads
+    std::size_t window = 64;       // maximal number of jobs read but not yet written out
+    bool ordered = true;           // write results in the input order or as soon as they are ready
+    std::size_t problems_cached = 16; // number of problem files kept open between jobs
+    std::size_t eval_threads = 0;  // threads of the pool shared by jobs to evaluate candidates concurrently (nelder-mead), 0 for none
+};
+
+/*
+ * Solves stream of jobs (one JSON object per line) on a pool of threads
+ * and writes one JSON result per line:
+ * {"seq": 0, "id": 7, "method": "Fastest descent", "stop_reason": "converged", "min": ..., "residual": ..., "time_ms": ...}
+ * (with "min_point" and "profile" members, if requested)
+ * or {"seq": 0, "id": 7, "error": "..."}, where seq is the number of the job in the input.
+ * At most window jobs are in flight, so memory use does not depend on the input size.
+ */
+struct BatchRunner
+{
+    explicit BatchRunner(BatchOptions options)
+        : m_options(options)
+        , m_eval_pool(options.eval_threads > 0 ? std::make_unique<util::ThreadPool>(options.eval_threads) : nullptr)
+    {}
+
+    /*
+     * Process all the input. Returns error only if the output cannot be written,
+     * errors of particular jobs are reported in their results.
+     */
+    util::MaybeErrorText run(std::istream & in, util::BufferedWriter & out);
+
+private:
+    std::string run_job(std::size_t seq, const std::string & line);
+    /*
+     * Job, which threw (e.g. out of memory), is reported as failed, so that the batch goes on.
+     */
+    std::string try_run_job(std::size_t seq, const std::string & line);
+    util::ErrorOr<util::NFunctionHandle> load_problem(const std::string & path);
+
+private:
+    BatchOptions m_options;
+    std::unique_ptr<util::ThreadPool> m_eval_pool; // separate from the pool running the jobs, which wait for it
+
+    std::mutex m_problems_mutex;
+    std::unordered_map<std::string, util::NFunctionHandle> m_problems; // loaded problems are shared with jobs
+    std::deque<std::string> m_problems_order;                     // to evict the oldest one
+};
+
+} // namespace min_nd
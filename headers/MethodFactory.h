@@ -0,0 +1,56 @@
+#pragma once
+
+#include "nd_methods/MinSearcher.h"
+#include "sd_methods/MinSearcher.h"
+
+#include "util/Misc.h"
+
+#include <memory>
+#include <string_view>
+
+namespace util {
+struct ThreadPool;
+} // namespace util
+
+namespace min_nd {
+
+/*
+ * Parameters of methods, which have more of them than the precision. Methods ignore parameters they do not have.
+ */
+struct MethodOptions
+{
+    uint parallel = 1;                 // vertices of nelder-mead moved on each iteration
+    util::ThreadPool * pool = nullptr; // where nelder-mead evaluates candidates concurrently, not owned (see NelderMead.h)
+};
+
+/*
+ * n-dimensional method together with the one dimensional method it uses (if any).
+ */
+struct MethodPair
+{
+    std::unique_ptr<min1d::MinSearcher> sd_method;
+    std::unique_ptr<min_nd::MinSearcher> nd_method;
+};
+
+/*
+ * Create one dimensional method by its name, nullptr if there is no such method.
+ * Names: golden, fibonacci, dichotomy, brent, parabole, brent-deriv, cubic.
+ */
+std::unique_ptr<min1d::MinSearcher> make_sd_method(std::string_view name, double eps);
+
+/*
+ * Create n-dimensional method by its name, nullptr if there is no such method.
+ * Names: gradient, fastest-descent, conjugate-gradient, mixed-conjugate-gradient,
+ * pipelined-conjugate-gradient, distributed-conjugate-gradient, nelder-mead, direct.
+ * distributed-conjugate-gradient forks worker processes only from a single threaded process,
+ * on pools of threads (BatchRunner, AsyncSolver) it solves in the calling thread.
+ * sd_method must outlive the created method.
+ */
+std::unique_ptr<min_nd::MinSearcher> make_nd_method(std::string_view name, double eps, min1d::MinSearcher & sd_method, const MethodOptions & options = {});
+
+/*
+ * Create both methods with the same required precision.
+ */
+util::ErrorOr<MethodPair> make_methods(std::string_view nd_name, std::string_view sd_name, double eps, const MethodOptions & options = {});
+
+} // namespace min_nd
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "nd_methods/ConjugateGrad.h"
+#include "nd_methods/DirectSolver.h"
+#include "nd_methods/DistributedConjugateGrad.h"
+#include "nd_methods/FastestDescent.h"
+#include "nd_methods/Gradient.h"
+#include "nd_methods/MinSearcher.h"
+#include "nd_methods/MixedConjugateGrad.h"
+#include "nd_methods/NelderMead.h"
+#include "nd_methods/PipelinedConjugateGrad.h"
+#include "sd_methods/Brent.h"
+#include "sd_methods/BrentDeriv.h"
+#include "sd_methods/Cubic.h"
+#include "sd_methods/Dichotomy.h"
+#include "sd_methods/Fibonacci.h"
+#include "sd_methods/Golden.h"
+#include "sd_methods/MinSearcher.h"
+#include "sd_methods/Parabole.h"
+
+#include "util/Misc.h"
+
+#include <memory>
+#include <variant>
+
+namespace min_nd {
+
+/*
+ * Compile time registry of methods: a method is stored in a variant of all known method types,
+ * so the type is resolved once per search by std::visit, and all calls inside of the search
+ * (including line searches of fastest descent) are made on concrete types.
+ */
+using SdMethodList = util::TypeList<min1d::Golden, min1d::Fibonacci, min1d::Dichotomy, min1d::Brent, min1d::Parabole, min1d::BrentDeriv, min1d::Cubic>;
+
+/*
+ * Fastest descent is instantiated for every one dimensional method.
+ */
+using NdMethodList = util::ConcatTypeLists<util::TypeList<Gradient>,
+                                           util::MapTypeList<BasicFastestDescent, SdMethodList>,
+                                           util::TypeList<ConjucateGrad, MixedConjucateGrad, PipelinedConjucateGrad, DistributedConjucateGrad, NelderMead, DirectSolver>>;
+
+template <class... Methods>
+using MethodVariant = std::variant<std::unique_ptr<Methods>...>;
+
+using SdMethodVariant = util::FromTypeList<MethodVariant, SdMethodList>;
+using NdMethodVariant = util::FromTypeList<MethodVariant, NdMethodList>;
+
+/*
+ * Access to the stored method through its base, for calls that do not depend on the method's type.
+ */
+inline min1d::MinSearcher & base_searcher(const SdMethodVariant & method)
+{
+    return std::visit([](auto & ptr) -> min1d::MinSearcher & { return *ptr; }, method);
+}
+
+inline MinSearcher & base_searcher(const NdMethodVariant & method)
+{
+    return std::visit([](auto & ptr) -> MinSearcher & { return *ptr; }, method);
+}
+
+} // namespace min_nd
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "AsyncSolver.h"
+#include "MethodRegistry.h"
+#include "ResultCache.h"
+
 #include "nd_methods/MinSearcher.h"
 #include "sd_methods/MinSearcher.h"
 
 #include "util/DiagMatrix.h"
+#include "util/ThreadPool.h"
 #include "util/Vector.h"
 
 #include <memory>
@@ -17,36 +22,85 @@ struct MinimizatorsAggregator
 {
     using MaybeErrorText = std::optional<std::string>;
 
-    using NMethodPtr = std::unique_ptr<min_nd::MinSearcher>;
-    using SDMethodPtr = std::unique_ptr<min1d::MinSearcher>;
+    using NMethodPtr = NdMethodVariant;
+    using SDMethodPtr = SdMethodVariant;
     using NFuncRef = std::reference_wrapper<util::NFunction>;
 
     MaybeErrorText setup();
 
     MaybeErrorText select_nd_method(uint method_id);
-    MaybeErrorText select_sd_method(uint method_id) { return select(method_id, m_sd_methods.size(), m_curr_sd_method); }
+    /*
+     * Fastest descent uses the selected one dimensional method.
+     */
+    MaybeErrorText select_sd_method(uint method_id);
     MaybeErrorText select_function(uint func_id);
 
     MaybeErrorText add_function(util::DiagMatrix a, util::Vector b, double c, double eigenvalue);
-
-    SearchRes search_min() { return curr_nd_searcher().find_min(); }
-    TracedSearchRes search_min_traced() { return curr_nd_searcher().find_min_traced(); }
+    /*
+     * Add function shared with the caller, it is not copied.
+     */
+    MaybeErrorText add_function(util::NFunctionHandle func);
+    /*
+     * Add function stored in problem file (see util/ProblemFile.h), its data is used without copying.
+     */
+    MaybeErrorText add_function_from_file(const std::string & path);
+
+    /*
+     * Cache results of search_min in memory, and in directory, if it is not empty.
+     * When only b differs from a cached problem, the search starts from the cached point.
+     */
+    MaybeErrorText enable_result_cache(std::size_t memory_budget, const std::string & directory = {});
+    void disable_result_cache() noexcept { m_result_cache.reset(); }
+    const ResultCache * result_cache() const noexcept { return m_result_cache.get(); }
+
+    SearchRes search_min();
+    TracedSearchRes search_min_traced()
+    {
+        return std::visit([](auto & method) { return method->find_min_traced(); }, m_nd_methods[m_curr_nd_method]);
+    }
+
+    /*
+     * Request to minimize the selected function, method names are the ones from MethodFactory.h.
+     * The request shares the function, so it does not depend on the aggregator.
+     */
+    SolveRequest make_request(std::string method, std::string sd_method = "golden", double eps = 1e-6) { return {curr_func(), std::move(method), std::move(sd_method), eps, std::nullopt, std::nullopt}; }
+
+    /*
+     * Solve requests asynchronously on the aggregator's executor, which is started on first use.
+     */
+    std::future<SolveResult> submit(SolveRequest request) { return async_solver().submit(std::move(request)); }
+    std::future<SolveResult> submit(SolveRequest request, SolveCallback on_done) { return async_solver().submit(std::move(request), std::move(on_done)); }
+    std::vector<std::future<SolveResult>> submit_all(std::vector<SolveRequest> requests) { return async_solver().submit_all(std::move(requests)); }
+    /*
+     * Race the methods and take the first converged result, when it is not known, which of them is the fastest.
+     */
+    std::future<PortfolioResult> submit_portfolio(SolveRequest request, std::vector<std::string> methods) { return async_solver().submit_portfolio(std::move(request), std::move(methods)); }
+    AsyncSolver & async_solver();
 
 private:
-    util::NFunction & curr_func() noexcept { return m_funcs[m_curr_func]; }
-    min_nd::MinSearcher & curr_nd_searcher() noexcept { return *m_nd_methods[m_curr_nd_method]; }
-    min1d::MinSearcher & curr_sd_searcher() noexcept { return *m_sd_methods[m_curr_sd_method]; }
+    const util::NFunctionHandle & curr_func() const noexcept { return m_funcs[m_curr_func]; }
+    min_nd::MinSearcher & curr_nd_searcher() noexcept { return base_searcher(m_nd_methods[m_curr_nd_method]); }
+    min1d::MinSearcher & curr_sd_searcher() noexcept { return base_searcher(m_sd_methods[m_curr_sd_method]); }
+
+    template <class Method>
+    SearchRes search_min(Method & searcher);
+
+    void rebind_fastest_descent();
 
     static MaybeErrorText select(uint method_id, std::size_t vec_size, std::size_t & to_select_idx);
 
 private:
-    std::vector<util::NFunction> m_funcs;
+    std::vector<util::NFunctionHandle> m_funcs; // shared with searchers and requests
+    std::unique_ptr<util::ThreadPool> m_eval_pool; // used by methods, so declared before them
     std::vector<NMethodPtr> m_nd_methods;
     std::vector<SDMethodPtr> m_sd_methods;
 
     std::size_t m_curr_func = 0;
     std::size_t m_curr_nd_method = 0;
     std::size_t m_curr_sd_method = 0;
+
+    std::unique_ptr<ResultCache> m_result_cache;
+    std::unique_ptr<AsyncSolver> m_async_solver;
 };
 
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/Misc.h"
+#include "util/NFunction.h"
+#include "util/Vector.h"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace min_nd {
+
+/*
+ * Content hash of a minimization problem.
+ * problem covers A, c, the method and its parameters; b is hashed separately,
+ * so that results for the same problem with another b can be found.
+ */
+struct ResultKey
+{
+    std::uint64_t problem;
+    std::uint64_t b;
+
+    bool operator==(const ResultKey & rhs) const noexcept { return problem == rhs.problem && b == rhs.b; }
+};
+
+ResultKey make_result_key(const util::NFunction & func, const MinSearcher & searcher);
+
+/*
+ * Cache of search results with two tiers:
+ *  - in memory: least recently used entries are evicted when their total size exceeds the budget;
+ *  - on disk (optional): append-only log of checksummed records plus append-only index of their offsets.
+ *    Appends are serialized between processes with a file lock, readers need no locks:
+ *    index entries are written after their records, and records are checked against their checksums.
+ * Thread safe.
+ */
+struct ResultCache
+{
+    explicit ResultCache(std::size_t memory_budget = std::size_t(64) << 20)
+        : m_memory_budget(memory_budget)
+    {}
+    ~ResultCache();
+
+    ResultCache(const ResultCache &) = delete;
+    ResultCache & operator=(const ResultCache &) = delete;
+
+    /*
+     * Use directory (created if needed) for the on-disk tier.
+     */
+    util::MaybeErrorText open_directory(const std::string & path);
+
+    std::optional<SearchRes> find(const ResultKey & key);
+    /*
+     * The most recent result of the same problem with another b: a good point to start the search from.
+     */
+    std::optional<util::Vector> find_warm_start(const ResultKey & key);
+
+    /*
+     * Store the result in both tiers. Failure to write to disk disables the on-disk tier.
+     */
+    util::MaybeErrorText insert(const ResultKey & key, const SearchRes & res);
+
+    std::size_t memory_hits() const
+    {
+        std::lock_guard guard(m_mutex);
+        return m_memory_hits;
+    }
+    std::size_t disk_hits() const
+    {
+        std::lock_guard guard(m_mutex);
+        return m_disk_hits;
+    }
+    std::size_t misses() const
+    {
+        std::lock_guard guard(m_mutex);
+        return m_misses;
+    }
+
+private:
+    struct KeyHash
+    {
+        std::size_t operator()(const ResultKey & key) const noexcept { return key.problem ^ (key.b * 0x9E3779B97F4A7C15ULL); }
+    };
+    struct MemoryEntry
+    {
+        ResultKey key;
+        SearchRes res;
+    };
+
+    void insert_to_memory(const ResultKey & key, const SearchRes & res);
+    std::optional<SearchRes> find_on_disk(const ResultKey & key);
+    std::optional<SearchRes> read_record(std::uint64_t offset, const ResultKey & key) const;
+    util::MaybeErrorText append_to_disk(const ResultKey & key, const SearchRes & res);
+    void read_new_index_entries();
+    void close_directory() noexcept;
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::size_t m_memory_budget;
+    std::size_t m_memory_used = 0;
+    std::list<MemoryEntry> m_lru; // the most recently used first
+    std::unordered_map<ResultKey, std::list<MemoryEntry>::iterator, KeyHash> m_memory;
+
+    int m_log_fd = -1;
+    int m_index_fd = -1;
+    std::uint64_t m_index_read = 0; // size of the index already loaded
+    std::unordered_map<ResultKey, std::uint64_t, KeyHash> m_disk; // record offsets in the log
+
+    std::unordered_map<std::uint64_t, ResultKey> m_latest; // the most recent key of each problem
+
+    std::size_t m_memory_hits = 0;
+    std::size_t m_disk_hits = 0;
+    std::size_t m_misses = 0;
+};
+
+} // namespace min_nd
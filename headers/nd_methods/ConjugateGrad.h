@@ -10,6 +10,14 @@ struct ConjucateGrad : MinSearcher
         : m_eps(eps)
     {}
 
+    std::string_view method_name() const noexcept override { return "Conjugate gradient"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps);
+    }
+
 protected:
     /*
      * Find n-dimensional function's minimum
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/ConstArray.h"
+#include "util/Misc.h"
+#include "util/SparseCholesky.h"
+
+#include <optional>
+
+namespace min_nd {
+
+/*
+ * Direct method: the minimum of f is the solution of A x = -b, found with Cholesky factorization of A
+ * (see util/SparseCholesky.h). The factorization of the last A is cached, so functions differing only in b
+ * are solved by the triangular sweeps alone; for diagonal A they are one division per coordinate.
+ * If A is not positive definite, f has no unique minimum: the search stops as failed at the start point.
+ */
+struct DirectSolver final : MinSearcher
+{
+    std::string_view method_name() const noexcept override { return "Direct (Cholesky)"; }
+
+protected:
+    /*
+     * Find n-dimensional function's minimum
+     * by solving A x = -b.
+     */
+    SearchRes find_min_impl() override;
+    /*
+     * Find n-dimensional function's minimum
+     * by solving A x = -b.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_traced_impl() override;
+
+private:
+    /*
+     * Factorization of A of the current function, made when A changes.
+     */
+    const util::ErrorOr<util::SparseCholesky> & factorization();
+
+    /*
+     * Minimum point of the current function, nothing if A is not positive definite.
+     */
+    std::optional<util::Vector> solve();
+
+private:
+    util::ConstArray<double> m_factored; // diagonal of the factorized A, holding it keeps the address unique
+    std::optional<util::ErrorOr<util::SparseCholesky>> m_factorization;
+};
+
+} // namespace min_nd
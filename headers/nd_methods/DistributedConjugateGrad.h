@@ -0,0 +1,39 @@
+#pragma once
+
+#include "nd_methods/ConjugateGrad.h"
+#include "nd_methods/MinSearcher.h"
+
+namespace min_nd {
+
+/*
+ * Conjugate gradient method split between several local processes.
+ * Every process owns a slice of A, b and of all vectors of the method,
+ * partial dot products are reduced through shared memory.
+ */
+struct DistributedConjucateGrad final : ConjucateGrad
+{
+    DistributedConjucateGrad(double eps, std::size_t processes)
+        : ConjucateGrad(eps)
+        , m_processes(processes)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Distributed conjugate gradient"; }
+
+protected:
+    /*
+     * Find n-dimensional function's minimum
+     * using conjugate gradient method in several processes.
+     */
+    SearchRes find_min_impl() override;
+    /*
+     * Find n-dimensional function's minimum
+     * using conjugate gradient method in several processes.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_traced_impl() override;
+
+protected:
+    std::size_t m_processes; // number of worker processes, including the calling one
+};
+
+} // namespace min_nd
@@ -1,26 +1,43 @@
 #pragma once
 
 #include "MinSearcher.h"
+#include "Stepper.h"
 #include "nd_methods/Gradient.h"
 #include "sd_methods/MinSearcher.h"
+#include "sd_methods/Stepper.h"
 
 #include "util/Function.h"
 #include "util/Vector.h"
 
+#include <type_traits>
+
 namespace min_nd {
 
-struct FastestDescent : Gradient    // derived from Gradient to reuse variables
+/*
+ * Fastest descent using one dimensional method of type SdSearcher.
+ * When SdSearcher is a concrete (final) method, line searches are called without virtual dispatch.
+ */
+template <class SdSearcher>
+struct BasicFastestDescent final : Gradient    // derived from Gradient to reuse variables
 {
-    FastestDescent(double eps, double max_step, min1d::MinSearcher & sd_searcher)
+    BasicFastestDescent(double eps, double max_step, SdSearcher & sd_searcher)
         : Gradient(eps, max_step)
         , m_sd_searcher(&sd_searcher)
     {}
 
+    std::string_view method_name() const noexcept override { return "Fastest descent"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        Gradient::hash_parameters(hasher);
+        m_sd_searcher->hash_parameters(hasher);
+    }
+
 public:
     /*
      * Set current one dimensional minimization method.
      */
-    void set_sd_searcher(min1d::MinSearcher & sd_searcher) { m_sd_searcher = &sd_searcher; }
+    void set_sd_searcher(SdSearcher & sd_searcher) { m_sd_searcher = &sd_searcher; }
 
 protected:
     /*
@@ -39,14 +56,86 @@ protected:
     /*
      * Solve the one dimensional minimization problem.
      */
-    min1d::SearchRes find_sd_min(util::Function && func) { return m_sd_searcher->find_min(std::move(func)); }
+    min1d::SearchRes find_sd_min(util::Function && func)
+    {
+        if constexpr (std::is_final_v<SdSearcher>) {
+            return min1d::MinSearcher::find_min_static(*m_sd_searcher, std::move(func));
+        } else {
+            return m_sd_searcher->find_min(std::move(func));
+        }
+    }
     /*
      * Returns function for which one dimensional minimization problem was solved.
      */
     const util::Function & last_sd_func() const noexcept { return m_sd_searcher->last_func(); }
+    /*
+     * Number of evaluations of function and its derivative made by the last one dimensional search.
+     */
+    uint sd_evals() const noexcept { return last_sd_func().call_count() + last_sd_func().deriv_call_count(); }
+
+private:
+    SdSearcher * m_sd_searcher;     // Current one dimensional minimization method
+};
+
+/*
+ * Fastest descent with one dimensional method chosen at run time.
+ */
+using FastestDescent = BasicFastestDescent<min1d::MinSearcher>;
+
+/*
+ * Fastest descent in reverse communication mode (see Stepper.h),
+ * line searches are made by one dimensional stepper of type LineStepper (min1d::GoldenStepper or min1d::BrentStepper).
+ * Points of the line search are requested as points of the n-dimensional space, without gradients;
+ * the found point is requested again with its gradient.
+ */
+template <class LineStepper>
+struct FastestDescentStepper final : Stepper
+{
+    /*
+     * Line searches are made on [0, max_step] along the antigradient; FastestDescent takes max_step = 1 / func.eigenvalue().
+     */
+    FastestDescentStepper(util::Vector start, double eps, double max_step, double sd_eps,
+                          util::SolveBudget budget = util::SolveBudget{MAX_ITER},
+                          util::SolveBudget sd_budget = util::SolveBudget{min1d::Stepper::MAX_ITER});
+
+    void tell(const EvalReply & reply);
+
+private:
+    /*
+     * Start the next line search, or finish.
+     */
+    void next();
+
+    /*
+     * Translate the request of the line search to points of the space.
+     */
+    void request_line_points();
 
 private:
-    min1d::MinSearcher * m_sd_searcher;     // Current one dimensional minimization method
+    enum class State
+    {
+        Start,      // value and gradient in the start point are requested
+        LineSearch, // points of the line search are requested
+        Gradient,   // gradient in the found point is requested
+    };
+
+    double m_eps;
+    double m_max_step;
+    double m_sd_eps;
+    util::SolveBudget m_sd_budget;
+    std::optional<LineStepper> m_line;
+    min1d::SearchRes m_sd_min{0., 0.};
+    util::Vector m_curr;
+    util::Vector m_grad;
+    double m_f_curr = 0.;
+    double m_grad_len_pow2 = 0.;
+    State m_state = State::Start;
 };
 
+template <class Method>
+inline constexpr bool is_fastest_descent_v = false;
+
+template <class SdSearcher>
+inline constexpr bool is_fastest_descent_v<BasicFastestDescent<SdSearcher>> = true;
+
 } // namespace min_nd
@@ -2,6 +2,7 @@
 
 #include "nd_methods/ConjugateGrad.h"
 #include "nd_methods/MinSearcher.h"
+#include "nd_methods/Stepper.h"
 
 namespace min_nd {
 
@@ -12,6 +13,8 @@ struct Gradient : ConjucateGrad
         , m_alpha(max_step)
     {}
 
+    std::string_view method_name() const noexcept override { return "Gradient descent"; }
+
 protected:
     /*
      * Find n-dimensional function's minimum
@@ -29,4 +32,48 @@ protected:
     double m_alpha; // max step
 };
 
+/*
+ * Gradient descent in reverse communication mode (see Stepper.h).
+ * Trial points are requested without gradients, the accepted point is requested again with its gradient.
+ */
+struct GradientStepper final : Stepper
+{
+    /*
+     * max_step is the first step tried on each iteration; Gradient takes 1 / func.eigenvalue().
+     */
+    GradientStepper(util::Vector start, double eps, double max_step, util::SolveBudget budget = util::SolveBudget{MAX_ITER});
+
+    void tell(const EvalReply & reply);
+
+private:
+    /*
+     * Start the next iteration, or finish.
+     */
+    void next();
+
+    /*
+     * Request the point reached by the step of current length.
+     */
+    void try_step();
+
+private:
+    enum class State
+    {
+        Start,    // value and gradient in the start point are requested
+        Trial,    // value in the trial point is requested
+        Gradient, // gradient in the accepted point is requested
+    };
+
+    double m_eps;
+    double m_max_step;
+    double m_alpha;           // current step
+    double m_step = 0.;       // accepted step of the current iteration
+    util::Vector m_curr;
+    util::Vector m_grad;
+    double m_f_curr = 0.;
+    double m_grad_len_pow2 = 0.;
+    uint m_iter_evals = 0;    // evaluations of the current iteration
+    State m_state = State::Start;
+};
+
 } // namespace min_nd
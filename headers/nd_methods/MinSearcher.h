@@ -1,9 +1,17 @@
 #pragma once
 
+#include "util/ConvergenceLog.h"
+#include "util/Hasher.h"
 #include "util/NFunction.h"
+#include "util/PerfCounters.h"
 #include "util/ReplayData.h"
+#include "util/SolveBudget.h"
+#include "util/Tracing.h"
 #include "util/Vector.h"
 
+#include <memory>
+#include <optional>
+#include <string_view>
 #include <vector>
 
 namespace min_nd {
@@ -12,6 +20,10 @@ struct SearchRes
 {
     util::Vector min_point;
     double min;
+    double residual; // length of gradient in min_point
+    util::StopReason stop_reason = util::StopReason::Converged; // if not converged, min_point is the best point found
+    util::ConvergenceLog history{}; // statistics of the last iterations
+    std::optional<util::PhaseStats> profile{}; // hardware counters by phases, if profiling was enabled
 };
 struct TracedSearchRes : SearchRes
 {
@@ -20,33 +32,171 @@ struct TracedSearchRes : SearchRes
 
 struct MinSearcher
 {
-    SearchRes find_min() { return find_min_impl(); }
-    SearchRes find_min(util::NFunction func)
+    virtual ~MinSearcher() = default;
+
+    SearchRes find_min()
+    {
+        util::TraceSpan span("solve");
+        start_search();
+        return finish_search(find_min_impl());
+    }
+    SearchRes find_min(util::NFunctionHandle func)
     {
-        m_last_func.emplace(std::move(func));
-        return find_min_impl();
+        set_func(std::move(func));
+        return find_min();
     }
 
-    TracedSearchRes find_min_traced() { return find_min_traced_impl(); }
-    TracedSearchRes find_min_traced(util::NFunction func)
+    TracedSearchRes find_min_traced()
     {
-        m_last_func.emplace(std::move(func));
+        util::TraceSpan span("solve");
+        start_search();
         m_replay_data.clear();
-        return find_min_traced_impl();
+        return finish_search(find_min_traced_impl());
+    }
+    TracedSearchRes find_min_traced(util::NFunctionHandle func)
+    {
+        set_func(std::move(func));
+        return find_min_traced();
     }
 
-    void set_func(util::NFunction func) { m_last_func.emplace(std::move(func)); }
+    /*
+     * The function is shared, not copied: switching methods or functions only moves the handle.
+     */
+    void set_func(util::NFunctionHandle func) { m_last_func = std::move(func); }
+    void set_func(util::NFunction func) { m_last_func = std::make_shared<const util::NFunction>(std::move(func)); }
     const util::NFunction & curr_func() const { return *m_last_func; }
+    const util::NFunctionHandle & func_handle() const noexcept { return m_last_func; }
+
+    /*
+     * Set point to start the search from. By default, and if dimensions do not match, the search starts from zero.
+     */
+    void set_start_point(std::optional<util::Vector> point) { m_start_point = std::move(point); }
+
+    /*
+     * Limit the following searches. By default only the number of iterations is limited, by MAX_ITER;
+     * it stays the limit, unless the budget sets max_iter.
+     */
+    void set_budget(util::SolveBudget budget) { m_budget = std::move(budget); }
+    const util::SolveBudget & budget() const noexcept { return m_budget; }
+
+    /*
+     * Profile the following searches with hardware counters (see util/PerfCounters.h).
+     * Counters measure only the thread, which runs the search.
+     */
+    void set_profiling(bool enabled) noexcept { m_profiling = enabled; }
+
+    virtual std::string_view method_name() const noexcept = 0;
+
+    /*
+     * Add to hasher everything except the function, that the result of the search depends on.
+     */
+    virtual void hash_parameters(util::Hasher & hasher) const noexcept
+    {
+        hasher.add(method_name());
+        if (m_start_point) {
+            hasher.add(m_start_point->data(), m_start_point->dims() * sizeof(double));
+        }
+    }
 
 protected:
-    static const uint MAX_ITER = 1000;
+    static constexpr uint MAX_ITER = 1000; // default limit of iterations
 protected:
+    util::Vector start_point() const
+    {
+        if (m_start_point && m_start_point->dims() == curr_func().dims()) {
+            return *m_start_point;
+        }
+        return util::Vector(curr_func().dims());
+    }
+
+    /*
+     * Check the budget before iteration iter_num. If the search must stop, the reason is remembered for the result.
+     */
+    bool budget_exhausted(uint iter_num) noexcept
+    {
+        m_stop_reason = m_search_budget.check(iter_num, m_evals);
+        return m_stop_reason.has_value();
+    }
+
+    /*
+     * Account the finished iteration: its evaluations count against the budget, its statistics go to the history.
+     */
+    void record_iteration(uint iter_num, double grad_len_pow2, double f, double alpha, double beta, uint evals) noexcept
+    {
+        m_evals += evals;
+        m_history.record(iter_num, grad_len_pow2, f, alpha, beta, evals);
+        if (util::tracing_enabled()) {
+            const auto now = util::trace_clock();
+            if (m_iteration_begin != 0) {
+                util::record_trace_span("iteration", m_iteration_begin, now);
+            }
+            m_iteration_begin = now;
+        }
+    }
+
+    /*
+     * Forget what the current search has recorded, to solve the problem again from the start (e.g. by a fallback).
+     * The budget is not restarted: deadline of the search stays.
+     */
+    void restart_search() noexcept
+    {
+        m_history.restart();
+        m_evals = 0;
+        m_stop_reason.reset();
+        m_replay_data.clear();
+        m_iteration_begin = util::tracing_enabled() ? util::trace_clock() : 0;
+    }
+
+    /*
+     * Attribute the following work of the search to the phase, if the search is profiled.
+     */
+    void enter_phase(util::Phase phase) noexcept
+    {
+        if (m_profiler) {
+            m_profiler->enter(phase);
+        }
+    }
+
     virtual SearchRes find_min_impl() = 0;
     virtual TracedSearchRes find_min_traced_impl() = 0;
 
+private:
+    void start_search() noexcept
+    {
+        m_history.restart();
+        m_evals = 0;
+        m_stop_reason.reset();
+        m_search_budget = m_budget.start(MAX_ITER);
+        m_iteration_begin = util::tracing_enabled() ? util::trace_clock() : 0;
+        if (m_profiling) {
+            m_profiler.emplace();
+        }
+    }
+
+    template <class Res>
+    Res finish_search(Res res)
+    {
+        res.stop_reason = m_stop_reason.value_or(util::StopReason::Converged);
+        res.history = m_history;
+        if (m_profiler) {
+            res.profile = m_profiler->finish();
+            m_profiler.reset();
+        }
+        return res;
+    }
+
 protected:
     util::ReplayData m_replay_data;
-    std::optional<util::NFunction> m_last_func;
+    util::ConvergenceLog m_history{util::ConvergenceLog::DEFAULT_CAPACITY}; // filled by methods on each iteration
+    util::SolveBudget m_budget;
+    util::SolveBudget m_search_budget;           // m_budget as resolved at the start of the current search
+    std::size_t m_evals = 0;                     // evaluations made by the current search
+    std::optional<util::StopReason> m_stop_reason; // set when the budget is exhausted
+    util::NFunctionHandle m_last_func;
+    std::optional<util::Vector> m_start_point;
+    bool m_profiling = false;
+    std::uint64_t m_iteration_begin = 0; // trace_clock() ticks, for iteration spans, when tracing is enabled
+    std::optional<util::PhaseProfiler> m_profiler; // exists during a profiled search
 };
 
 } // namespace min_nd
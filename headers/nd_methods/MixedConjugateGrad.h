@@ -0,0 +1,45 @@
+#pragma once
+
+#include "nd_methods/ConjugateGrad.h"
+#include "nd_methods/MinSearcher.h"
+
+namespace min_nd {
+
+/*
+ * Conjugate gradient method with A, p and gradient stored in float.
+ * Dot products and the position are accumulated in double,
+ * and the gradient is periodically recalculated in double to keep the final accuracy.
+ */
+struct MixedConjucateGrad final : ConjucateGrad
+{
+    MixedConjucateGrad(double eps, uint recalc_period = 50)
+        : ConjucateGrad(eps)
+        , m_recalc_period(recalc_period)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Mixed precision conjugate gradient"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        ConjucateGrad::hash_parameters(hasher);
+        hasher.add_value(m_recalc_period);
+    }
+
+protected:
+    /*
+     * Find n-dimensional function's minimum
+     * using mixed precision conjugate gradient method.
+     */
+    SearchRes find_min_impl() override;
+    /*
+     * Find n-dimensional function's minimum
+     * using mixed precision conjugate gradient method.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_traced_impl() override;
+
+protected:
+    uint m_recalc_period; // number of iterations between recalculations of the gradient in double
+};
+
+} // namespace min_nd
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/ThreadPool.h"
+
+namespace min_nd {
+
+/*
+ * Parallel Nelder-Mead simplex method (Lee and Wiswall): derivative-free, the search uses only values of the function.
+ * Gradient in the best vertex is calculated after each iteration only for the convergence history.
+ * On each iteration the parallel worst vertices are moved independently, each of them reflected through the centroid
+ * of the rest of the simplex, then expanded or contracted; candidates of all of them are evaluated concurrently.
+ * With one such vertex it is the classic method.
+ * The simplex is kept in one array, vertex after vertex.
+ * Candidates are evaluated on the given pool together with the searching thread, or by the searching thread alone without it.
+ * The pool is not owned and must not be the one running the search itself.
+ */
+struct NelderMead final : MinSearcher
+{
+    NelderMead(double eps, uint parallel = 1, double initial_size = 1., util::ThreadPool * pool = nullptr)
+        : m_eps(eps)
+        , m_parallel(std::max(1u, parallel))
+        , m_initial_size(initial_size)
+        , m_pool(pool)
+    {}
+
+    void set_pool(util::ThreadPool * pool) noexcept { m_pool = pool; }
+
+    std::string_view method_name() const noexcept override { return "Nelder-Mead"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps).add_value(m_parallel).add_value(m_initial_size);
+    }
+
+protected:
+    /*
+     * Find n-dimensional function's minimum
+     * using Nelder-Mead method.
+     */
+    SearchRes find_min_impl() override;
+    /*
+     * Find n-dimensional function's minimum
+     * using Nelder-Mead method.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_traced_impl() override;
+
+protected:
+    double m_eps;         // required spread of the values and size of the simplex
+    uint m_parallel;      // number of vertices moved on each iteration
+    double m_initial_size; // length of the initial simplex's edges, relative to the start point's coordinates
+    util::ThreadPool * m_pool; // where candidates are evaluated, if set
+};
+
+} // namespace min_nd
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "nd_methods/ConjugateGrad.h"
+#include "nd_methods/MinSearcher.h"
+
+namespace min_nd {
+
+/*
+ * Pipelined conjugate gradient method (Ghysels and Vanroose).
+ * Both dot products of an iteration are merged into one reduction,
+ * which is computed in the same pass over the data as the matrix by vector product and the vector updates.
+ */
+struct PipelinedConjucateGrad final : ConjucateGrad
+{
+    PipelinedConjucateGrad(double eps, uint recalc_period = 50)
+        : ConjucateGrad(eps)
+        , m_recalc_period(recalc_period)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Pipelined conjugate gradient"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        ConjucateGrad::hash_parameters(hasher);
+        hasher.add_value(m_recalc_period);
+    }
+
+protected:
+    /*
+     * Find n-dimensional function's minimum
+     * using pipelined conjugate gradient method.
+     */
+    SearchRes find_min_impl() override;
+    /*
+     * Find n-dimensional function's minimum
+     * using pipelined conjugate gradient method.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_traced_impl() override;
+
+protected:
+    uint m_recalc_period; // number of iterations between recalculations of the residual from the position
+};
+
+} // namespace min_nd
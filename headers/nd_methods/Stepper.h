@@ -0,0 +1,162 @@
+#pragma once
+
+#include "MinSearcher.h"
+
+#include "util/ConvergenceLog.h"
+#include "util/FiniteDifference.h"
+#include "util/NFunction.h"
+#include "util/SolveBudget.h"
+#include "util/Vector.h"
+
+#include <cassert>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+namespace min_nd {
+
+/*
+ * Points, where a stepper needs the function.
+ */
+struct EvalRequest
+{
+    std::vector<util::Vector> points;
+    bool with_gradient = false; // whether gradients in the points are needed besides values
+};
+
+/*
+ * Values in the requested points, in the same order, and gradients, if they were requested.
+ */
+struct EvalReply
+{
+    std::vector<double> values;
+    std::vector<util::Vector> gradients;
+};
+
+/*
+ * Answer the request by calculating the function.
+ */
+inline EvalReply evaluate(const util::NFunction & func, const EvalRequest & request)
+{
+    EvalReply reply;
+    reply.values.reserve(request.points.size());
+    for (const auto & point : request.points) {
+        reply.values.push_back(func(point));
+        if (request.with_gradient) {
+            reply.gradients.push_back(func.grad(point));
+        }
+    }
+    return reply;
+}
+
+/*
+ * Answer the request for a black-box function, gradients are calculated by finite differences.
+ * So gradient and fastest descent steppers minimize functions, which are known only by their values.
+ */
+inline EvalReply evaluate(const util::FiniteDifference & func, const EvalRequest & request)
+{
+    EvalReply reply;
+    reply.values.reserve(request.points.size());
+    for (const auto & point : request.points) {
+        reply.values.push_back(func(point));
+        if (request.with_gradient) {
+            reply.gradients.push_back(func.grad(point, reply.values.back()));
+        }
+    }
+    return reply;
+}
+
+/*
+ * Base of reverse communication ("ask/tell") n-dimensional searchers, see also min1d::Stepper.
+ * Stepper does not call the function: ask() gives points, where it needs the function (and maybe its gradient),
+ * and tell() resumes it with the reply, until the search is done:
+ *
+ *     GradientStepper st(start, 1e-6, 1 / max_eigenvalue);
+ *     while (!st.done()) {
+ *         st.tell(evaluate(func, st.ask()));
+ *     }
+ *     auto res = st.result();
+ *
+ * Steppers are plain values, so requests of many searches can be combined into one batch for an external evaluator.
+ * Black-box functions without analytic gradient can be answered with util::FiniteDifference.
+ * Steppers make the same steps as the corresponding searchers.
+ */
+struct Stepper
+{
+    bool done() const noexcept { return m_request.points.empty(); }
+
+    /*
+     * Points to evaluate the function in. Empty, when the search is done.
+     */
+    const EvalRequest & ask() const noexcept { return m_request; }
+
+    /*
+     * Result of the finished search.
+     */
+    SearchRes result() const
+    {
+        assert(done() && "Stepper::result called before the search is done");
+        return {m_min_point, m_min, m_residual, m_stop_reason.value_or(util::StopReason::Converged), m_history, std::nullopt};
+    }
+
+    static constexpr uint MAX_ITER = 1000; // default limit of iterations, the same as searchers have
+
+protected:
+    Stepper(std::size_t dims, util::SolveBudget budget)
+        : m_min_point(dims)
+        , m_budget(budget.start(MAX_ITER))
+    {}
+
+    /*
+     * Check the budget before the next iteration. If the search must stop, the reason is remembered for the result.
+     */
+    bool budget_exhausted() noexcept
+    {
+        m_stop_reason = m_budget.check(m_iter, m_evals);
+        return m_stop_reason.has_value();
+    }
+
+    /*
+     * Account the finished iteration, as MinSearcher::record_iteration does.
+     */
+    void record_iteration(double grad_len_pow2, double f, double alpha, double beta, uint evals) noexcept
+    {
+        m_evals += evals;
+        m_history.record(m_iter, grad_len_pow2, f, alpha, beta, evals);
+        ++m_iter;
+    }
+
+    void check_reply(const EvalReply & reply) const noexcept
+    {
+        assert(reply.values.size() == m_request.points.size() && "Stepper::tell needs one value per requested point");
+        assert((!m_request.with_gradient || reply.gradients.size() == m_request.points.size()) && "Stepper::tell needs requested gradients");
+    }
+
+    void request(util::Vector point, bool with_gradient)
+    {
+        m_request.points.clear();
+        m_request.points.push_back(std::move(point));
+        m_request.with_gradient = with_gradient;
+    }
+
+    void finish(util::Vector point, double f, double grad_len_pow2)
+    {
+        m_request.points.clear();
+        m_min_point = std::move(point);
+        m_min = f;
+        m_residual = std::sqrt(grad_len_pow2);
+    }
+
+protected:
+    EvalRequest m_request;
+    util::Vector m_min_point;
+    double m_min = 0.;
+    double m_residual = 0.;
+    util::SolveBudget m_budget;
+    std::optional<util::StopReason> m_stop_reason;
+    util::ConvergenceLog m_history{util::ConvergenceLog::DEFAULT_CAPACITY};
+    uint m_iter = 0;
+    std::size_t m_evals = 0;
+};
+
+} // namespace min_nd
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "BatchSearcher.h"
+
+namespace min1d {
+
+struct BatchDichotomy : public BatchSearcher
+{
+    BatchDichotomy(double sigma, double eps)
+        : m_sigma(sigma)
+        , m_eps(eps)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Batch dichotomy"; }
+
+    void change_parameters(double new_eps, double new_sigma) noexcept
+    {
+        m_eps = new_eps;
+        m_sigma = new_sigma;
+    }
+
+protected:
+    /*
+     * Find minimums of a batch of unimodal functions
+     * using dichotomy method.
+     */
+    BatchSearchRes find_min_impl() override;
+
+private:
+    double m_sigma; // method's parameter
+    double m_eps;   // required accuracy
+};
+
+} // namespace min1d
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "BatchSearcher.h"
+
+namespace min1d {
+
+struct BatchFibonacci : public BatchSearcher
+{
+    BatchFibonacci(double eps)
+        : m_eps(eps)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Batch Fibonacci"; }
+
+    void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
+
+protected:
+    /*
+     * Find minimums of a batch of unimodal functions
+     * using fibonacci method.
+     */
+    BatchSearchRes find_min_impl() override;
+
+    double m_eps; // required accuracy
+};
+
+} // namespace min1d
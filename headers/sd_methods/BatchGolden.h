@@ -0,0 +1,31 @@
+#pragma once
+
+#include "BatchSearcher.h"
+
+#include <cmath>
+
+namespace min1d {
+
+struct BatchGolden : public BatchSearcher
+{
+    static inline const double TAU = (sqrt(5) - 1) / 2; // golden ratio coefficient
+
+    BatchGolden(double eps)
+        : m_eps(eps)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Batch golden ratio"; }
+
+    void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
+
+protected:
+    /*
+     * Find minimums of a batch of unimodal functions
+     * using golden ratio method.
+     */
+    BatchSearchRes find_min_impl() override;
+
+    double m_eps; // required accuracy
+};
+
+} // namespace min1d
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "util/BatchFunction.h"
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace min1d {
+
+struct BatchSearchRes
+{
+    std::vector<double> min_point, min;
+};
+
+/*
+ * Solves many independent one dimensional problems at once.
+ * Every lane keeps its own segment, all lanes are advanced together
+ * and lanes that have converged are masked out.
+ */
+struct BatchSearcher
+{
+    virtual ~BatchSearcher() = default;
+
+    BatchSearchRes find_min(util::BatchFunction func)
+    {
+        m_last_func.emplace(std::move(func));
+        m_last_func->reset();
+        return find_min_impl();
+    }
+
+    const util::BatchFunction & last_func() const noexcept { return *m_last_func; }
+
+public:
+    virtual std::string_view method_name() const noexcept = 0;
+
+protected:
+    virtual BatchSearchRes find_min_impl() = 0;
+
+    /*
+     * Calculate function values in points xs[i] for every lane i with active[i] set.
+     * Results are written into ys[i], values of inactive lanes are left untouched.
+     * Returns number of calculated points.
+     */
+    std::size_t calculate_active(const std::vector<double> & xs, std::vector<double> & ys, const std::vector<char> & active);
+
+    /*
+     * Calculate function values in the middles of segments of all lanes.
+     */
+    BatchSearchRes calculate_middles(const std::vector<double> & from, const std::vector<double> & to);
+
+protected:
+    std::optional<util::BatchFunction> m_last_func;
+
+private:
+    // scratch buffers for compacting active lanes
+    std::vector<std::size_t> m_lanes;
+    std::vector<double> m_xs, m_ys;
+};
+
+} // namespace min1d
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MinSearcher.h"
+#include "Stepper.h"
 
 #include "util/Function.h"
 #include "util/ReplayData.h"
@@ -9,8 +10,10 @@
 
 namespace min1d {
 
-struct Brent : public MinSearcher
+struct Brent final : public MinSearcher
 {
+    friend struct MinSearcher; // for find_min_static
+
     static inline const double TAU = (3 - sqrt(5)) / 2; // coefficient as in gloden ratio
 
     Brent(double eps)
@@ -20,6 +23,12 @@ struct Brent : public MinSearcher
 
     std::string_view method_name() const noexcept override { return "Brent"; }
 
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps);
+    }
+
     void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
 
 protected:
@@ -39,4 +48,35 @@ protected:
     double m_eps; // required accuracy
 };
 
+/*
+ * Brent's method in reverse communication mode (see Stepper.h).
+ * Every request has one point.
+ */
+struct BrentStepper final : public Stepper
+{
+    BrentStepper(util::Function::Bounds bounds, double eps, util::SolveBudget budget = util::SolveBudget{MAX_ITER});
+
+    void tell(const std::vector<double> & values);
+
+private:
+    /*
+     * Check the exit condition and request the next point u, or finish with x.
+     */
+    void next();
+
+    /*
+     * Narrow the segment and update points x, w, v according to the value in u.
+     */
+    void update(double f_u) noexcept;
+
+private:
+    util::Function::Bounds m_bnds;
+    double m_eps;
+    double m_x, m_w, m_v;
+    double m_f_x = 0., m_f_w = 0., m_f_v = 0.;
+    double m_u = 0.;
+    double m_step, m_prev_step;
+    bool m_started = false; // whether value in the first point is told
+};
+
 } // namespace min1d
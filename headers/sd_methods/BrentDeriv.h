@@ -0,0 +1,53 @@
+#pragma once
+
+#include "MinSearcher.h"
+
+#include "util/Function.h"
+#include "util/ReplayData.h"
+
+#include <cmath>
+
+namespace min1d {
+
+/*
+ * Brent's method which uses function's derivative instead of parabolic interpolation.
+ * Requires function with derivative.
+ */
+struct BrentDeriv final : public MinSearcher
+{
+    friend struct MinSearcher; // for find_min_static
+
+    static inline const double TAU = (3 - sqrt(5)) / 2; // coefficient as in golden ratio
+
+    BrentDeriv(double eps)
+        : m_eps(eps)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Brent with derivatives"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps);
+    }
+
+    void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
+
+protected:
+    /*
+     * Find unimodal function's minimum
+     * using Brent's method with derivatives.
+     */
+    SearchRes find_min_impl() noexcept override;
+
+    /*
+     * Find unimodal function's minimum
+     * using Brent's method with derivatives.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_tracked_impl() noexcept override;
+
+    double m_eps; // required accuracy
+};
+
+} // namespace min1d
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "MinSearcher.h"
+
+#include "util/Function.h"
+#include "util/ReplayData.h"
+
+namespace min1d {
+
+/*
+ * Safeguarded cubic interpolation.
+ * Requires function with derivative.
+ */
+struct Cubic final : public MinSearcher
+{
+    friend struct MinSearcher; // for find_min_static
+
+    Cubic(double eps)
+        : m_eps(eps)
+    {}
+
+    std::string_view method_name() const noexcept override { return "Cubic interpolation"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps);
+    }
+
+    void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
+
+protected:
+    /*
+     * Find unimodal function's minimum
+     * using safeguarded cubic interpolation method.
+     */
+    SearchRes find_min_impl() noexcept override;
+
+    /*
+     * Find unimodal function's minimum
+     * using safeguarded cubic interpolation method.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_tracked_impl() noexcept override;
+
+    double m_eps; // required accuracy
+};
+
+} // namespace min1d
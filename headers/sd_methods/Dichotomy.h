@@ -7,8 +7,10 @@
 
 namespace min1d {
 
-struct Dichotomy : public MinSearcher
+struct Dichotomy final : public MinSearcher
 {
+    friend struct MinSearcher; // for find_min_static
+
     Dichotomy(double sigma, double eps)
         : m_sigma(sigma)
         , m_eps(eps)
@@ -16,6 +18,12 @@ struct Dichotomy : public MinSearcher
 
     std::string_view method_name() const noexcept override { return "Dichotomy"; }
 
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps).add_value(m_sigma);
+    }
+
     void change_parameters(double new_eps, double new_sigma) noexcept
     {
         m_eps = new_eps;
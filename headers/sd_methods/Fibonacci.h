@@ -7,14 +7,22 @@
 
 namespace min1d {
 
-struct Fibonacci : public MinSearcher
+struct Fibonacci final : public MinSearcher
 {
+    friend struct MinSearcher; // for find_min_static
+
     Fibonacci(double eps)
         : m_eps(eps)
     {}
 
     std::string_view method_name() const noexcept override { return "Fibonacci"; }
 
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps);
+    }
+
     void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
 
 protected:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MinSearcher.h"
+#include "Stepper.h"
 
 #include "util/Function.h"
 #include "util/ReplayData.h"
@@ -9,8 +10,10 @@
 
 namespace min1d {
 
-struct Golden : public MinSearcher
+struct Golden final : public MinSearcher
 {
+    friend struct MinSearcher; // for find_min_static
+
     static inline const double TAU = (sqrt(5) - 1) / 2; // golden ratio coefficient
 
     Golden(double eps)
@@ -20,6 +23,12 @@ struct Golden : public MinSearcher
 
     std::string_view method_name() const noexcept override { return "Golden ratio"; }
 
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps);
+    }
+
     void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
 
 protected:
@@ -39,4 +48,36 @@ protected:
     double m_eps; // required accuracy
 };
 
+/*
+ * Golden ratio method in reverse communication mode (see Stepper.h).
+ * The first request has two points, the following ones have one.
+ */
+struct GoldenStepper final : public Stepper
+{
+    GoldenStepper(util::Function::Bounds bounds, double eps, util::SolveBudget budget = util::SolveBudget{MAX_ITER});
+
+    void tell(const std::vector<double> & values);
+
+private:
+    /*
+     * Choose the next segment and request the new point in it, or request the answer.
+     */
+    void next();
+
+private:
+    enum class State
+    {
+        Start,    // both points are requested
+        NewLeft,  // x_left is requested
+        NewRight, // x_right is requested
+        Answer,   // the middle of the segment is requested
+    };
+
+    util::Function::Bounds m_bnds;
+    double m_eps;
+    double m_x_left, m_f_left = 0.;
+    double m_x_right, m_f_right = 0.;
+    State m_state = State::Start;
+};
+
 } // namespace min1d
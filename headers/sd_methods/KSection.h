@@ -0,0 +1,57 @@
+#pragma once
+
+#include "MinSearcher.h"
+
+#include "util/Function.h"
+#include "util/ReplayData.h"
+#include "util/ThreadPool.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace min1d {
+
+/*
+ * Search for expensive functions: on each iteration k interior points
+ * are calculated concurrently, so one iteration takes about as long as one calculation.
+ */
+struct KSection final : public MinSearcher
+{
+    friend struct MinSearcher; // for find_min_static
+
+    KSection(double eps, uint points)
+        : m_eps(eps)
+        , m_points(std::max(points, 2u))
+        , m_pool(std::make_unique<util::ThreadPool>(m_points - 1))
+    {}
+
+    std::string_view method_name() const noexcept override { return "K-section"; }
+
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps).add_value(m_points);
+    }
+
+    void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
+
+protected:
+    /*
+     * Find unimodal function's minimum
+     * using k-section method.
+     */
+    SearchRes find_min_impl() noexcept override;
+
+    /*
+     * Find unimodal function's minimum
+     * using k-section method.
+     * Outputs tracing information.
+     */
+    TracedSearchRes find_min_tracked_impl() noexcept override;
+
+    double m_eps;  // required accuracy
+    uint m_points; // number of interior points calculated on each iteration
+    std::unique_ptr<util::ThreadPool> m_pool;
+};
+
+} // namespace min1d
@@ -1,16 +1,22 @@
 #pragma once
 
 #include "util/Function.h"
+#include "util/Hasher.h"
 #include "util/ReplayData.h"
+#include "util/SolveBudget.h"
+#include "util/Tracing.h"
 
+#include <optional>
 #include <ostream>
 #include <string_view>
+#include <type_traits>
 
 namespace min1d {
 
 struct SearchRes
 {
     double min_point, min;
+    util::StopReason stop_reason = util::StopReason::Converged; // if not converged, min_point is the best point found
 };
 
 struct TracedSearchRes : SearchRes
@@ -24,18 +30,46 @@ struct MinSearcher
 
     SearchRes find_min(util::Function func)
     {
-        m_last_func.emplace(std::move(func));
-        m_last_func->reset();
-        return find_min_impl();
+        util::TraceSpan span("line_search");
+        set_func(std::move(func));
+        return finish_search(find_min_impl());
     }
     TracedSearchRes find_min_tracked(util::Function func)
     {
-        m_last_func.emplace(std::move(func));
+        util::TraceSpan span("line_search");
+        set_func(std::move(func));
         m_replay_data.clear();
-        m_last_func->reset();
-        return find_min_tracked_impl();
+        return finish_search(find_min_tracked_impl());
+    }
+
+    /*
+     * Same as searcher.find_min(func), but the implementation is called directly, not through the virtual table.
+     * Searcher must be final, so that its implementation is the one the virtual call would reach.
+     */
+    template <class Searcher>
+    static SearchRes find_min_static(Searcher & searcher, util::Function func)
+    {
+        static_assert(std::is_final_v<Searcher>, "static dispatch requires final searcher");
+        util::TraceSpan span("line_search");
+        MinSearcher & base = searcher;
+        base.set_func(std::move(func));
+        return base.finish_search(searcher.Searcher::find_min_impl());
     }
 
+    /*
+     * Limit the following searches. By default only the number of iterations is limited, by MAX_ITER;
+     * it stays the limit, unless the budget sets max_iter.
+     * Evaluations of the function and of its derivative are counted together.
+     */
+    void set_budget(util::SolveBudget budget) { m_budget = std::move(budget); }
+    const util::SolveBudget & budget() const noexcept { return m_budget; }
+
+    /*
+     * Enable evaluation cache of given capacity on functions passed to this searcher.
+     * Zero capacity disables it.
+     */
+    void set_cache_capacity(std::size_t capacity) noexcept { m_cache_capacity = capacity; }
+
     const util::ReplayData & replay_data() const noexcept { return m_replay_data; }
 
     const util::Function & last_func() const noexcept { return *m_last_func; }
@@ -43,13 +77,58 @@ struct MinSearcher
 public:
     virtual std::string_view method_name() const noexcept = 0;
 
+    /*
+     * Add to hasher everything except the function, that the result of the search depends on.
+     * Deadline and cancellation are not hashed: they stop the search, but do not change its steps.
+     */
+    virtual void hash_parameters(util::Hasher & hasher) const noexcept
+    {
+        hasher.add(method_name());
+        hasher.add_value(m_budget.max_iter.value_or(MAX_ITER)).add_value(m_budget.max_evals);
+    }
+
+protected:
+    static constexpr uint MAX_ITER = 100; // default limit of iterations
+
 protected:
     virtual SearchRes find_min_impl() noexcept = 0;
     virtual TracedSearchRes find_min_tracked_impl() noexcept = 0;
 
+    /*
+     * Check the budget before iteration iter_num. If the search must stop, the reason is remembered for the result.
+     */
+    bool budget_exhausted(uint iter_num) noexcept
+    {
+        m_stop_reason = m_search_budget.check(iter_num, m_last_func->call_count() + m_last_func->deriv_call_count());
+        return m_stop_reason.has_value();
+    }
+
+private:
+    template <class Res>
+    Res finish_search(Res res) const
+    {
+        res.stop_reason = m_stop_reason.value_or(util::StopReason::Converged);
+        return res;
+    }
+
+    void set_func(util::Function && func)
+    {
+        m_last_func.emplace(std::move(func));
+        if (m_cache_capacity > 0) {
+            m_last_func->enable_cache(m_cache_capacity);
+        }
+        m_last_func->reset();
+        m_stop_reason.reset();
+        m_search_budget = m_budget.start(MAX_ITER);
+    }
+
 protected:
     util::ReplayData m_replay_data;
     std::optional<util::Function> m_last_func;
+    std::size_t m_cache_capacity = 0;
+    util::SolveBudget m_budget;
+    util::SolveBudget m_search_budget; // m_budget as resolved at the start of the current search
+    std::optional<util::StopReason> m_stop_reason; // set when the budget is exhausted
 };
 
 } // namespace min1d
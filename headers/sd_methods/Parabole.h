@@ -6,14 +6,22 @@
 #include "util/ReplayData.h"
 
 namespace min1d {
-struct Parabole : public MinSearcher
+struct Parabole final : public MinSearcher
 {
+    friend struct MinSearcher; // for find_min_static
+
     Parabole(double eps)
         : m_eps(eps)
     {}
 
     std::string_view method_name() const noexcept override { return "Parabole"; }
 
+    void hash_parameters(util::Hasher & hasher) const noexcept override
+    {
+        MinSearcher::hash_parameters(hasher);
+        hasher.add_value(m_eps);
+    }
+
     void change_parameters(double new_eps) noexcept { m_eps = new_eps; }
 
 protected:
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "MinSearcher.h"
+
+#include "util/SolveBudget.h"
+
+#include <cassert>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace min1d {
+
+/*
+ * Base of reverse communication ("ask/tell") searchers.
+ * Stepper does not call the function: ask() gives points, where it needs the function's values,
+ * and tell() resumes it with the values in the same order, until the search is done:
+ *
+ *     GoldenStepper st({-1., 1.}, 1e-6);
+ *     while (!st.done()) {
+ *         std::vector<double> values;
+ *         for (double x : st.ask()) {
+ *             values.push_back(f(x));
+ *         }
+ *         st.tell(values);
+ *     }
+ *     auto res = st.result();
+ *
+ * Points of one request do not depend on each other, so they can be evaluated in a batch.
+ * Steppers are plain values, so requests of many searches can be combined, while each of them waits for its values.
+ * Steppers make the same steps as the corresponding searchers.
+ */
+struct Stepper
+{
+    bool done() const noexcept { return m_points.empty(); }
+
+    /*
+     * Points to evaluate the function in. Empty, when the search is done.
+     */
+    const std::vector<double> & ask() const noexcept { return m_points; }
+
+    /*
+     * Result of the finished search.
+     */
+    SearchRes result() const noexcept
+    {
+        assert(done() && "Stepper::result called before the search is done");
+        return {m_min_point, m_min, m_stop_reason.value_or(util::StopReason::Converged)};
+    }
+
+    /*
+     * Number of values told so far; the budget limits it as evaluations.
+     */
+    std::size_t evaluations() const noexcept { return m_evals; }
+
+    static constexpr uint MAX_ITER = 100; // default limit of iterations, the same as searchers have
+
+protected:
+    explicit Stepper(util::SolveBudget budget)
+        : m_budget(budget.start(MAX_ITER))
+    {}
+
+    /*
+     * Check the budget before the next iteration. If the search must stop, the reason is remembered for the result.
+     */
+    bool budget_exhausted() noexcept
+    {
+        m_stop_reason = m_budget.check(m_iter, m_evals);
+        return m_stop_reason.has_value();
+    }
+
+    /*
+     * Account values told for all the points requested.
+     */
+    void accept(const std::vector<double> & values) noexcept
+    {
+        assert(values.size() == m_points.size() && "Stepper::tell needs one value per requested point");
+        m_evals += values.size();
+    }
+
+    void request(double x) { m_points.assign(1, x); }
+
+    void finish(double x, double f) noexcept
+    {
+        m_points.clear();
+        m_min_point = x;
+        m_min = f;
+    }
+
+protected:
+    std::vector<double> m_points; // requested points
+    util::SolveBudget m_budget;
+    std::optional<util::StopReason> m_stop_reason;
+    uint m_iter = 0;
+    std::size_t m_evals = 0;
+    double m_min_point = std::numeric_limits<double>::quiet_NaN();
+    double m_min = std::numeric_limits<double>::quiet_NaN();
+};
+
+} // namespace min1d
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Misc.h"
+
+#include <cassert>
+#include <vector>
+
+namespace util {
+
+/*
+ * A batch of independent one dimensional functions stored in structure-of-arrays layout.
+ * All of them are calculated through one vectorized callback.
+ */
+struct BatchFunction
+{
+    BatchFunction(CalculateBatchFunc calculate, std::vector<double> from, std::vector<double> to)
+        : m_calculate(std::move(calculate))
+        , m_from(std::move(from))
+        , m_to(std::move(to))
+    {
+        assert(m_from.size() == m_to.size() && "BatchFunction: bounds size mismatch");
+    }
+
+    /*
+     * Calculate values of lanes[i]-th function in point xs[i] for each i in [0, count)
+     */
+    void operator()(const std::size_t * lanes, const double * xs, double * ys, std::size_t count) const
+    {
+        ++m_call_count;
+        m_eval_count += count;
+        m_calculate(lanes, xs, ys, count);
+    }
+
+    std::size_t size() const noexcept { return m_from.size(); }
+
+    const std::vector<double> & from() const noexcept { return m_from; }
+    const std::vector<double> & to() const noexcept { return m_to; }
+
+    uint call_count() const noexcept { return m_call_count; }
+    std::size_t eval_count() const noexcept { return m_eval_count; }
+
+    void reset() noexcept
+    {
+        m_call_count = 0;
+        m_eval_count = 0;
+    }
+
+private:
+    CalculateBatchFunc m_calculate;
+    std::vector<double> m_from;
+    std::vector<double> m_to;
+    mutable uint m_call_count = 0;          // number of vectorized callback invocations
+    mutable std::size_t m_eval_count = 0;   // total number of calculated points
+};
+
+} // namespace util
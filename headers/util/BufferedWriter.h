@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Misc.h"
+
+#include <string>
+#include <string_view>
+
+namespace util {
+
+/*
+ * Accumulates output in memory and writes it to file descriptor in large chunks.
+ * Not thread safe: concurrent writers must be serialized by the caller.
+ */
+struct BufferedWriter
+{
+    explicit BufferedWriter(int fd, std::size_t capacity = 1 << 16);
+    ~BufferedWriter() { flush(); }
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter & operator=(const BufferedWriter &) = delete;
+
+    void write(std::string_view data);
+
+    /*
+     * Write all buffered data out. After the first failure all the output is dropped.
+     */
+    MaybeErrorText flush();
+
+private:
+    int m_fd;
+    std::size_t m_capacity;
+    std::string m_buffer;
+    MaybeErrorText m_error;
+};
+
+} // namespace util
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace util {
+
+/*
+ * Immutable array, that either owns its data or views memory owned by someone else
+ * (for example, a mapped file). Copies share the same data.
+ */
+template <class T>
+struct ConstArray
+{
+    ConstArray() = default;
+
+    explicit ConstArray(std::vector<T> data)
+    {
+        auto owner = std::make_shared<const std::vector<T>>(std::move(data));
+        m_data = owner->data();
+        m_size = owner->size();
+        m_owner = std::move(owner);
+    }
+
+    /*
+     * View size elements starting at data, owner keeps them alive.
+     */
+    ConstArray(const T * data, std::size_t size, std::shared_ptr<const void> owner)
+        : m_owner(std::move(owner))
+        , m_data(data)
+        , m_size(size)
+    {}
+
+    const T * data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+
+    const T * begin() const noexcept { return m_data; }
+    const T * end() const noexcept { return m_data + m_size; }
+
+    const T & operator[](std::size_t idx) const noexcept { return m_data[idx]; }
+    const T & front() const noexcept { return m_data[0]; }
+    const T & back() const noexcept { return m_data[m_size - 1]; }
+
+private:
+    std::shared_ptr<const void> m_owner;
+    const T * m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+} // namespace util
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+/*
+ * Scalars describing one iteration of an n-dimensional method.
+ */
+struct IterationStats
+{
+    uint iter_num;
+    double grad_len_pow2;  // squared length of the gradient after the iteration
+    double f;              // function's value after the iteration
+    double alpha;          // step coefficient
+    double beta;           // conjugate direction coefficient, 0 for methods without it
+    uint evals;            // function evaluations (or products by A) made on the iteration
+    std::uint64_t time_ns; // time since the start of the search
+};
+
+/*
+ * Fixed-capacity ring buffer of per-iteration statistics.
+ * Memory is allocated once, recording an iteration is a few stores and a clock read,
+ * so it is kept on for every search; only the last capacity iterations are retained.
+ */
+struct ConvergenceLog
+{
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+    /*
+     * Empty log, that cannot record anything.
+     */
+    ConvergenceLog() = default;
+
+    explicit ConvergenceLog(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_entries.resize(size);
+        m_mask = size - 1;
+    }
+
+    /*
+     * Forget all recorded iterations and start counting time anew.
+     */
+    void restart() noexcept
+    {
+        m_total = 0;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    void record(uint iter_num, double grad_len_pow2, double f, double alpha, double beta, uint evals) noexcept
+    {
+        if (m_entries.empty()) {
+            return;
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_entries[m_total & m_mask] = {iter_num, grad_len_pow2, f, alpha, beta, evals,
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())};
+        ++m_total;
+    }
+
+    /*
+     * Number of retained iterations.
+     */
+    std::size_t size() const noexcept { return m_total < m_entries.size() ? m_total : m_entries.size(); }
+    bool empty() const noexcept { return m_total == 0; }
+    std::size_t capacity() const noexcept { return m_entries.size(); }
+    /*
+     * Number of iterations recorded since the restart, including dropped ones.
+     */
+    std::size_t total() const noexcept { return m_total; }
+
+    /*
+     * idx-th of the retained iterations, the oldest one has index 0.
+     */
+    const IterationStats & operator[](std::size_t idx) const noexcept { return m_entries[(m_total - size() + idx) & m_mask]; }
+    const IterationStats & back() const noexcept { return m_entries[(m_total - 1) & m_mask]; }
+
+    /*
+     * Average factor, by which squared gradient length decreased per iteration over the last window iterations.
+     * Values close to 1 mean stagnation.
+     */
+    double decrease_rate(std::size_t window) const noexcept
+    {
+        if (size() < 2) {
+            return 1.;
+        }
+        window = std::min(window, size() - 1);
+        const double first = (*this)[size() - 1 - window].grad_len_pow2;
+        const double last = back().grad_len_pow2;
+        if (!(first > 0.)) {
+            return 1.;
+        }
+        return std::pow(last / first, 1. / window);
+    }
+
+    /*
+     * Whether squared gradient length decreased less than min_decrease times over the last window iterations.
+     */
+    bool is_stagnating(std::size_t window, double min_decrease) const noexcept
+    {
+        if (size() <= window) {
+            return false;
+        }
+        const double first = (*this)[size() - 1 - window].grad_len_pow2;
+        return back().grad_len_pow2 * min_decrease > first;
+    }
+
+private:
+    std::vector<IterationStats> m_entries;
+    std::size_t m_mask = 0;
+    std::size_t m_total = 0;
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+};
+
+} // namespace util
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "util/ConstArray.h"
+#include "util/Tracing.h"
 #include "util/Vector.h"
 
 #include <cassert>
@@ -8,51 +10,87 @@
 
 namespace util {
 
-struct DiagMatrix
+/*
+ * Diagonal matrix. Its data is immutable, so copies share it.
+ */
+template <class T>
+struct BasicDiagMatrix
 {
-    explicit DiagMatrix(std::size_t dims, double min = 0., double max = 0.)
-        : m_data(dims, 0.)
-    {
-        assert(dims > 0 && "zero-dimensional matrix is strange and not supported");
-        std::mt19937 rand_engn(std::random_device{}());
-        std::uniform_real_distribution dst(min, max);
+    explicit BasicDiagMatrix(std::size_t dims, double min = 0., double max = 0.)
+        : m_data(random_diag(dims, min, max))
+    {}
 
-        for (auto & el : m_data) {
-            el = dst(rand_engn);
-        }
-        m_data.front() = min;
-        m_data.back() = max;
-    }
+    explicit BasicDiagMatrix(std::vector<T> diag)
+        : m_data(std::move(diag))
+    {}
 
-    explicit DiagMatrix(std::vector<double> diag)
+    /*
+     * Matrix over diagonal stored somewhere else, e.g. in a mapped file.
+     */
+    explicit BasicDiagMatrix(ConstArray<T> diag)
         : m_data(std::move(diag))
     {}
 
-    Vector operator*(const Vector & vec) const
+    /*
+     * Convert matrix of another precision.
+     */
+    template <class U, class = std::enable_if_t<!std::is_same_v<T, U>>>
+    explicit BasicDiagMatrix(const BasicDiagMatrix<U> & other)
+        : m_data(std::vector<T>(other.m_data.begin(), other.m_data.end()))
+    {}
+
+    BasicVector<T> operator*(const BasicVector<T> & vec) const
     {
         assert(dims() == vec.dims() && "Matrix by Vector dim mismatch");
-        std::vector res(m_data);
+        TraceSpan span("mat_vec");
+        std::vector<T> res(m_data.begin(), m_data.end());
         auto other_it = vec.m_data.begin();
         for (auto & el : res) {
             el *= *other_it++;
         }
-        return Vector(std::move(res));
+        return BasicVector<T>(std::move(res));
     }
 
-    explicit operator Vector() const
+    explicit operator BasicVector<T>() const
     {
-        return Vector(m_data);
+        return BasicVector<T>(std::vector<T>(m_data.begin(), m_data.end()));
     }
 
+    const T * data() const noexcept { return m_data.data(); }
+
     std::size_t dims() const noexcept { return m_data.size(); }
 
+    const ConstArray<T> & diag() const noexcept { return m_data; }
+
+private:
+    static std::vector<T> random_diag(std::size_t dims, double min, double max)
+    {
+        assert(dims > 0 && "zero-dimensional matrix is strange and not supported");
+        std::vector<T> data(dims, T(0));
+        std::mt19937 rand_engn(std::random_device{}());
+        std::uniform_real_distribution dst(min, max);
+
+        for (auto & el : data) {
+            el = static_cast<T>(dst(rand_engn));
+        }
+        data.front() = static_cast<T>(min);
+        data.back() = static_cast<T>(max);
+        return data;
+    }
+
 private:
-    std::vector<double> m_data;
+    template <class U>
+    friend struct BasicDiagMatrix;
+
+    ConstArray<T> m_data;
 };
 
-inline std::ostream & operator<<(std::ostream & out, const DiagMatrix & mtx)
+using DiagMatrix = BasicDiagMatrix<double>;
+
+template <class T>
+inline std::ostream & operator<<(std::ostream & out, const BasicDiagMatrix<T> & mtx)
 {
-    return out << Vector(mtx);
+    return out << BasicVector<T>(mtx);
 }
 
 }
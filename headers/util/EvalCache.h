@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace util {
+
+/*
+ * Small fixed-size table of already calculated function values.
+ * Open addressing with linear probing, keys are exact bit patterns of the points,
+ * so only repeated probes of the very same point are found.
+ * When a probe sequence is full, the entry in the home slot is replaced.
+ */
+struct EvalCache
+{
+    explicit EvalCache(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_entries.resize(size);
+        m_mask = size - 1;
+    }
+
+    std::optional<double> find(double x) const noexcept
+    {
+        const std::uint64_t key = to_key(x);
+        for (std::size_t i = 0, pos = home(key); i < probe_len(); ++i, pos = (pos + 1) & m_mask) {
+            const auto & entry = m_entries[pos];
+            if (!entry.used) {
+                break;
+            }
+            if (entry.key == key) {
+                return entry.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void insert(double x, double y) noexcept
+    {
+        const std::uint64_t key = to_key(x);
+        const std::size_t start = home(key);
+        for (std::size_t i = 0, pos = start; i < probe_len(); ++i, pos = (pos + 1) & m_mask) {
+            auto & entry = m_entries[pos];
+            if (!entry.used || entry.key == key) {
+                entry = {key, y, true};
+                return;
+            }
+        }
+        m_entries[start] = {key, y, true};
+    }
+
+    void clear() noexcept
+    {
+        for (auto & entry : m_entries) {
+            entry.used = false;
+        }
+    }
+
+    std::size_t capacity() const noexcept { return m_entries.size(); }
+
+private:
+    struct Entry
+    {
+        std::uint64_t key = 0;
+        double value = 0.;
+        bool used = false;
+    };
+
+    static constexpr std::size_t MAX_PROBE = 8;
+
+    static std::uint64_t to_key(double x) noexcept
+    {
+        std::uint64_t key;
+        std::memcpy(&key, &x, sizeof(key));
+        return key;
+    }
+
+    /*
+     * splitmix64 finalizer: neighbouring doubles differ only in low bits of mantissa,
+     * so bits are mixed before taking them modulo table size.
+     */
+    std::size_t home(std::uint64_t key) const noexcept
+    {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key & m_mask;
+    }
+
+    std::size_t probe_len() const noexcept { return std::min(MAX_PROBE, m_entries.size()); }
+
+private:
+    std::vector<Entry> m_entries;
+    std::size_t m_mask = 0;
+};
+
+} // namespace util
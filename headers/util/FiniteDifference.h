@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Misc.h"
+#include "ThreadPool.h"
+#include "Vector.h"
+
+#include <vector>
+
+namespace util {
+
+enum class DifferenceScheme
+{
+    Forward, // (f(x + h) - f(x)) / h: one evaluation per coordinate, error O(h)
+    Central, // (f(x + h) - f(x - h)) / 2h: two evaluations per coordinate, error O(h^2)
+};
+
+/*
+ * Black-box function of n variables with gradient calculated by finite differences.
+ * Step of coordinate j is h_j = rel_step * max(|x_j|, 1), where rel_step balances truncation and rounding errors:
+ * sqrt of machine epsilon for forward differences, cube root of it for central ones.
+ * The step is then adjusted, so that x_j + h_j is exactly representable and the division uses the step really made.
+ * Coordinates are split into chunks, which are evaluated in parallel on the pool, if it is given.
+ * Each chunk copies the point once into its scratch vector and perturbs one coordinate at a time,
+ * so the function must be safe to call concurrently.
+ */
+struct FiniteDifference
+{
+    FiniteDifference(std::size_t dims, CalculateNFunc calculate, DifferenceScheme scheme = DifferenceScheme::Central, ThreadPool * pool = nullptr);
+
+    double operator()(const Vector & x) const;
+
+    Vector grad(const Vector & x) const;
+
+    /*
+     * Forward differences reuse known value in x, central ones ignore it.
+     */
+    Vector grad(const Vector & x, double f_x) const;
+
+    /*
+     * Number of function evaluations made for one gradient.
+     */
+    std::size_t grad_evaluations() const noexcept { return m_scheme == DifferenceScheme::Central ? 2 * m_dims : m_dims; }
+
+    std::size_t dims() const noexcept { return m_dims; }
+    DifferenceScheme scheme() const noexcept { return m_scheme; }
+
+private:
+    /*
+     * Fill grad[from, to) using scratch, which must be equal to x.
+     */
+    void grad_range(const Vector & x, double f_x, std::size_t from, std::size_t to, std::vector<double> & scratch, double * grad) const;
+
+private:
+    std::size_t m_dims;
+    CalculateNFunc m_calculate;
+    DifferenceScheme m_scheme;
+    ThreadPool * m_pool;
+    double m_rel_step;
+};
+
+} // namespace util
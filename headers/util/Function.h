@@ -1,11 +1,16 @@
 #pragma once
 
+#include "EvalCache.h"
 #include "Misc.h"
 
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace util {
 
+struct ThreadPool;
+
 struct Function
 {
     struct Bounds
@@ -20,33 +25,90 @@ struct Function
 public:
     Function(std::string as_string, CalculateFunc calculate, Bounds bounds);
     Function(CalculateFunc calculate, Bounds bounds);
+    /*
+     * Function with known derivative, for methods that use it.
+     */
+    Function(std::string as_string, CalculateFunc calculate, CalculateFunc derivative, Bounds bounds);
+    Function(CalculateFunc calculate, CalculateFunc derivative, Bounds bounds);
 
     void reset(std::string as_string, CalculateFunc calculate);
 
     /*
-     * Calculate function's value in point x
+     * Calculate function's value in point x.
+     * If evaluation cache is enabled, values of already calculated points are taken from it.
      */
     double operator()(double x) const
     {
+        if (m_cache) {
+            if (auto cached = m_cache->find(x)) {
+                ++m_cache_hits;
+                return *cached;
+            }
+            ++m_cache_misses;
+        }
         ++m_call_count;
-        return m_calculate(x);
+        const double res = m_calculate(x);
+        if (m_cache) {
+            m_cache->insert(x, res);
+        }
+        return res;
     }
 
+    /*
+     * Calculate function's values in points xs concurrently, using pool's threads.
+     * The underlying calculation must be safe to call from several threads at once.
+     */
+    void operator()(const std::vector<double> & xs, std::vector<double> & ys, ThreadPool & pool) const;
+
+    /*
+     * Calculate function's derivative in point x
+     */
+    double derivative(double x) const
+    {
+        ++m_deriv_call_count;
+        return m_derivative(x);
+    }
+
+    bool has_derivative() const noexcept { return static_cast<bool>(m_derivative); }
+
+    /*
+     * Remember up to about capacity last calculated values, so repeated probes of the same point are free.
+     */
+    void enable_cache(std::size_t capacity) { m_cache.emplace(capacity); }
+    void disable_cache() noexcept { m_cache.reset(); }
+
     uint call_count() const noexcept { return m_call_count; }
+    uint deriv_call_count() const noexcept { return m_deriv_call_count; }
+    uint cache_hits() const noexcept { return m_cache_hits; }
+    uint cache_misses() const noexcept { return m_cache_misses; }
 
     Bounds bounds() const noexcept { return m_bounds; }
 
     const std::string & to_string() const noexcept { return m_as_string; }
 
-    void reset() noexcept { m_call_count = 0; }
+    void reset() noexcept
+    {
+        m_call_count = 0;
+        m_deriv_call_count = 0;
+        m_cache_hits = 0;
+        m_cache_misses = 0;
+        if (m_cache) {
+            m_cache->clear();
+        }
+    }
 
     friend std::ostream & operator<<(std::ostream & out, const Function & func);
 
 private:
     std::string m_as_string;
     CalculateFunc m_calculate;
+    CalculateFunc m_derivative; // may be empty
     Bounds m_bounds;
-    mutable uint m_call_count;
+    mutable uint m_call_count = 0;
+    mutable uint m_deriv_call_count = 0;
+    mutable uint m_cache_hits = 0;
+    mutable uint m_cache_misses = 0;
+    mutable std::optional<EvalCache> m_cache;
 };
 
 } // namespace util
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace util {
+
+/*
+ * Fast non-cryptographic 64-bit hash of data given in parts.
+ * Each part is hashed with four independent lanes (in the spirit of xxHash) and mixed into the state,
+ * so hashing large arrays runs close to memory bandwidth.
+ */
+struct Hasher
+{
+    explicit Hasher(std::uint64_t seed = 0) noexcept
+        : m_state(seed)
+    {}
+
+    Hasher & add(const void * data, std::size_t size) noexcept;
+
+    Hasher & add(std::string_view str) noexcept
+    {
+        add_value(str.size());
+        return add(str.data(), str.size());
+    }
+
+    template <class T>
+    Hasher & add_value(const T & value) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values can be hashed by their bytes");
+        return add(&value, sizeof(value));
+    }
+
+    std::uint64_t digest() const noexcept;
+
+private:
+    std::uint64_t m_state;
+};
+
+} // namespace util
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Misc.h"
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace util {
+
+struct JsonValue;
+
+using JsonArray = std::vector<JsonValue>;
+using JsonObject = std::vector<std::pair<std::string, JsonValue>>; // members in the order of appearance
+
+/*
+ * Minimal JSON document model, enough to read job descriptors and write results.
+ */
+struct JsonValue
+{
+    using Storage = std::variant<std::nullptr_t, bool, double, std::string, JsonArray, JsonObject>;
+
+    JsonValue(Storage value = nullptr)
+        : m_value(std::move(value))
+    {}
+
+    template <class T>
+    const T * get_if() const noexcept { return std::get_if<T>(&m_value); }
+
+    /*
+     * Member of the object by key; nullptr if this is not an object or there is no such key.
+     */
+    const JsonValue * find(std::string_view key) const noexcept;
+
+    const Storage & value() const noexcept { return m_value; }
+
+private:
+    Storage m_value;
+};
+
+/*
+ * Parse the whole text as one JSON value.
+ */
+ErrorOr<JsonValue> parse_json(std::string_view text);
+
+/*
+ * Append serialized value to out.
+ */
+void write_json(std::string & out, const JsonValue & value);
+void write_json(std::string & out, std::string_view str);
+void write_json(std::string & out, double number);
+
+} // namespace util
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Misc.h"
+
+#include <memory>
+#include <string>
+
+namespace util {
+
+/*
+ * File mapped into memory as a whole.
+ */
+struct MappedFile
+{
+    /*
+     * Map existing file for reading.
+     */
+    static ErrorOr<std::shared_ptr<MappedFile>> open(const std::string & path);
+    /*
+     * Create (or truncate) file of given size and map it for writing.
+     */
+    static ErrorOr<std::shared_ptr<MappedFile>> create(const std::string & path, std::size_t size);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    void * data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+
+    /*
+     * Flush written data to the file.
+     */
+    MaybeErrorText sync() const;
+
+private:
+    MappedFile(void * data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {}
+
+private:
+    void * m_data;
+    std::size_t m_size;
+};
+
+} // namespace util
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Misc.h"
+
+#include <string>
+
+namespace util {
+
+/*
+ * Convert problem given in Matrix Market (.mtx) files into problem file (see ProblemFile.h).
+ * A must be a square diagonal matrix in coordinate format, off-diagonal nonzeros are rejected.
+ * b is a vector in array or coordinate format; if b_path is empty, b is zero.
+ * Entries are streamed straight into the mapped output, so memory use does not depend on problem size.
+ */
+MaybeErrorText import_matrix_market(const std::string & a_path, const std::string & b_path, double c, const std::string & out_path);
+
+} // namespace util
@@ -2,12 +2,29 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 #include <type_traits>
+#include <variant>
+#include <vector>
 
 namespace util {
 
 using CalculateFunc = std::function<double(double)>;
 using CalculateNFunc = std::function<double(const std::vector<double> &)>;
+/*
+ * Vectorized calculation: for each i in [0, count) put value of the lanes[i]-th function
+ * in point xs[i] into ys[i].
+ */
+using CalculateBatchFunc = std::function<void(const std::size_t * lanes, const double * xs, double * ys, std::size_t count)>;
+
+using MaybeErrorText = std::optional<std::string>;
+
+/*
+ * Either a value or text of an error that did not let to get it.
+ */
+template <class T>
+using ErrorOr = std::variant<T, std::string>;
 
 template <class... Funcs>
 struct Overloaded : public Funcs...
@@ -28,6 +45,29 @@ struct TypeList;
 
 namespace detail {
 
+template <class... Lists>
+struct ConcatTypeListsImpl;
+
+template <class... Types>
+struct ConcatTypeListsImpl<TypeList<Types...>>
+{
+    using type = TypeList<Types...>;
+};
+
+template <class... Types1, class... Types2, class... Rest>
+struct ConcatTypeListsImpl<TypeList<Types1...>, TypeList<Types2...>, Rest...> : ConcatTypeListsImpl<TypeList<Types1..., Types2...>, Rest...>
+{
+};
+
+template <template <class Type> class Wrapper, class List>
+struct MapTypeListImpl;
+
+template <template <class Type> class Wrapper, class... Types>
+struct MapTypeListImpl<Wrapper, TypeList<Types...>>
+{
+    using type = TypeList<Wrapper<Types>...>;
+};
+
 template <template <class... DestTypes> class Getter, class List>
 struct FromTypeListImpl;
 
@@ -40,4 +80,16 @@ struct FromTypeListImpl<Getter, TypeList<SrcTypes...>>
 
 template <template <class... DestTypes> class Getter, class List>
 using FromTypeList = typename detail::FromTypeListImpl<Getter, List>::type;
+
+/*
+ * TypeList with types of all Lists in order.
+ */
+template <class... Lists>
+using ConcatTypeLists = typename detail::ConcatTypeListsImpl<Lists...>::type;
+
+/*
+ * TypeList<Wrapper<T>...> for List = TypeList<T...>.
+ */
+template <template <class Type> class Wrapper, class List>
+using MapTypeList = typename detail::MapTypeListImpl<Wrapper, List>::type;
 } // namespace util
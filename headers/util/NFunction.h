@@ -1,43 +1,96 @@
 #pragma once
 
-#include "Misc.h"
+#include "ConstArray.h"
 #include "DiagMatrix.h"
+#include "Misc.h"
 
 #include "util/Vector.h"
 
+#include <cassert>
+#include <memory>
+
 namespace util {
 
-struct NFunction
+/*
+ * Quadratic function f(x) = 1/2 * (Ax, x) + (b, x) + c.
+ * A and b are stored with elements of type T.
+ * They are immutable, so copies of the function share them.
+ */
+template <class T>
+struct BasicNFunction
 {
-    NFunction(DiagMatrix a, Vector b, double c, double eigenvalue)
+    BasicNFunction(BasicDiagMatrix<T> a, BasicVector<T> b, double c, double eigenvalue)
+        : m_a(std::move(a))
+        , m_b(std::move(b).take_data())
+        , m_c(c)
+        , max_eigenvalue(eigenvalue)
+    {}
+
+    /*
+     * Function over b stored somewhere else, e.g. in a mapped file.
+     */
+    BasicNFunction(BasicDiagMatrix<T> a, ConstArray<T> b, double c, double eigenvalue)
         : m_a(std::move(a))
         , m_b(std::move(b))
         , m_c(c)
         , max_eigenvalue(eigenvalue)
     {}
 
+    /*
+     * Convert function of another precision.
+     */
+    template <class U, class = std::enable_if_t<!std::is_same_v<T, U>>>
+    explicit BasicNFunction(const BasicNFunction<U> & other)
+        : m_a(other.a())
+        , m_b(std::vector<T>(other.b().begin(), other.b().end()))
+        , m_c(other.c())
+        , max_eigenvalue(other.eigenvalue())
+    {}
+
     double operator()(const std::vector<double> x) const { return m_calculate(x); }
 
-    double operator()(const Vector & vec) const
+    double operator()(const BasicVector<T> & vec) const
     {
-        return m_a * vec * vec * 0.5 + m_b * vec + m_c;
+        assert(dims() == vec.dims() && "NFunction dim mismatch");
+        double res = 0.;
+        for (std::size_t i = 0; i < dims(); ++i) {
+            const double x = vec[i];
+            res += (0.5 * m_a.diag()[i] * x + m_b[i]) * x;
+        }
+        return res + m_c;
     }
 
-    Vector grad(const Vector & vec) const { return m_a * vec + m_b; }
+    BasicVector<T> grad(const BasicVector<T> & vec) const
+    {
+        assert(dims() == vec.dims() && "NFunction dim mismatch");
+        std::vector<T> res(dims());
+        for (std::size_t i = 0; i < dims(); ++i) {
+            res[i] = m_a.diag()[i] * vec[i] + m_b[i];
+        }
+        return BasicVector<T>(std::move(res));
+    }
 
     std::size_t dims() const noexcept { return m_a.dims(); }
 
-    const DiagMatrix & a() const noexcept { return m_a; }
-    const Vector & b() const noexcept { return m_b; }
+    const BasicDiagMatrix<T> & a() const noexcept { return m_a; }
+    const ConstArray<T> & b() const noexcept { return m_b; }
     double c() const noexcept { return m_c; }
     double eigenvalue() const noexcept { return max_eigenvalue; }
 
 private:
-    DiagMatrix m_a;
-    Vector m_b;
+    BasicDiagMatrix<T> m_a;
+    ConstArray<T> m_b;
     double m_c;
     double max_eigenvalue;
     CalculateNFunc m_calculate; // will probably be replaced with A, b, c parameters
 };
 
-} // namespace util
\ No newline at end of file
+using NFunction = BasicNFunction<double>;
+
+/*
+ * Shared immutable function: searchers, requests and threads hold the same object,
+ * so passing a function around neither copies nor re-counts its data.
+ */
+using NFunctionHandle = std::shared_ptr<const NFunction>;
+
+} // namespace util
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace util {
+
+/*
+ * Phases of a search, which hardware counters are attributed to.
+ */
+enum class Phase
+{
+    MatVec,     // products with A: evaluations of the function and of its gradient
+    VectorOps,  // dot products and axpy-like updates of vectors
+    LineSearch, // one dimensional searches (including evaluations made by them)
+    Trace,      // recording of the replay data
+    Other,      // everything else: setup, budget checks, convergence history
+};
+inline constexpr std::size_t PHASE_COUNT = 5;
+
+std::string_view phase_name(Phase phase) noexcept;
+
+/*
+ * Counters accumulated by one phase.
+ * Memory traffic is estimated as last level cache misses times the cache line size,
+ * so instructions / bytes approximates the arithmetic intensity of the phase's kernels.
+ */
+struct PhaseCounters
+{
+    static constexpr std::uint64_t CACHE_LINE = 64;
+
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t llc_misses = 0;
+    std::uint64_t time_ns = 0;
+    std::uint64_t entries = 0; // how many times the phase was entered
+
+    std::uint64_t bytes() const noexcept { return llc_misses * CACHE_LINE; }
+};
+
+/*
+ * Profile of one search. If hardware counters are not available (not Linux, no permission, virtual machine),
+ * only time and entries are counted.
+ */
+struct PhaseStats
+{
+    bool hardware = false;
+    std::array<PhaseCounters, PHASE_COUNT> phases;
+
+    const PhaseCounters & operator[](Phase phase) const noexcept { return phases[static_cast<std::size_t>(phase)]; }
+};
+
+/*
+ * Group of hardware counters (cycles, instructions, last level cache misses) of the calling thread,
+ * opened with perf_event_open. Values only grow, differences of two reads give the counts between them.
+ * Must be read on the thread, which created it.
+ */
+struct PerfCounters
+{
+    struct Values
+    {
+        std::uint64_t cycles = 0, instructions = 0, llc_misses = 0;
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters & operator=(const PerfCounters &) = delete;
+
+    bool available() const noexcept { return m_group_fd >= 0; }
+
+    /*
+     * Current values, zeros if counters are not available.
+     */
+    Values read() const noexcept;
+
+private:
+    int m_group_fd = -1;
+    std::array<int, 2> m_member_fds{-1, -1};
+};
+
+/*
+ * Attributes counters to phases: at each moment exactly one phase is active (Other at the start),
+ * enter() closes the active phase and opens another one, so phases never overlap and add up to the whole search.
+ */
+struct PhaseProfiler
+{
+    PhaseProfiler();
+
+    void enter(Phase phase) noexcept;
+
+    /*
+     * Close the active phase and return the profile.
+     */
+    PhaseStats finish() noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void close_active() noexcept;
+
+private:
+    PerfCounters m_counters;
+    PhaseStats m_stats;
+    Phase m_active = Phase::Other;
+    PerfCounters::Values m_since_values;
+    Clock::time_point m_since_time;
+};
+
+} // namespace util
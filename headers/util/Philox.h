@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace util {
+
+/*
+ * Counter-based random generator Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+ * Output is a pure function of the key (seed) and the counter, so any element of a random sequence
+ * can be generated independently: data can be filled in parallel and the result does not depend on the number of threads.
+ * Stream separates independent sequences generated with the same seed.
+ */
+struct Philox
+{
+    using Block = std::array<std::uint32_t, 4>;
+
+    explicit Philox(std::uint64_t seed) noexcept
+        : m_key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}
+    {}
+
+    Block operator()(std::uint64_t counter, std::uint64_t stream = 0) const noexcept
+    {
+        Block ctr{static_cast<std::uint32_t>(counter), static_cast<std::uint32_t>(counter >> 32),
+                  static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)};
+        std::array<std::uint32_t, 2> key = m_key;
+        for (int round = 0; round < ROUNDS; ++round) {
+            const std::uint64_t prod0 = static_cast<std::uint64_t>(M0) * ctr[0];
+            const std::uint64_t prod1 = static_cast<std::uint64_t>(M1) * ctr[2];
+            ctr = {static_cast<std::uint32_t>(prod1 >> 32) ^ ctr[1] ^ key[0], static_cast<std::uint32_t>(prod1),
+                   static_cast<std::uint32_t>(prod0 >> 32) ^ ctr[3] ^ key[1], static_cast<std::uint32_t>(prod0)};
+            key[0] += W0;
+            key[1] += W1;
+        }
+        return ctr;
+    }
+
+    /*
+     * Uniformly distributed double in [0, 1) made of 53 random bits.
+     */
+    static double to_unit(std::uint32_t hi, std::uint32_t lo) noexcept
+    {
+        const std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32 | lo) >> 11;
+        return static_cast<double>(bits) * 0x1p-53;
+    }
+
+private:
+    static constexpr int ROUNDS = 10;
+    static constexpr std::uint32_t M0 = 0xD2511F53;
+    static constexpr std::uint32_t M1 = 0xCD9E8D57;
+    static constexpr std::uint32_t W0 = 0x9E3779B9;
+    static constexpr std::uint32_t W1 = 0xBB67AE85;
+
+    std::array<std::uint32_t, 2> m_key;
+};
+
+} // namespace util
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Misc.h"
+#include "NFunction.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace util {
+
+/*
+ * Binary container of a quadratic problem (A, b, c and bounds of A's eigenvalues).
+ * Layout: header, then diagonal of A and b as arrays of native doubles, each aligned to 64 bytes.
+ * The file is mapped and functions loaded from it use the mapped data directly.
+ */
+struct ProblemFileHeader
+{
+    static constexpr char MAGIC[8] = {'N', 'D', 'M', 'P', 'R', 'O', 'B', '\0'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t ENDIAN_MARK = 0x01020304; // written natively, to detect foreign byte order
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t dims;
+    std::uint64_t a_offset; // offset of A's diagonal from the file's start, in bytes
+    std::uint64_t b_offset; // offset of b from the file's start, in bytes
+    double c;
+    double min_eigenvalue;
+    double max_eigenvalue;
+    std::uint8_t reserved[64];
+};
+static_assert(sizeof(ProblemFileHeader) == 128, "problem file header layout changed");
+
+/*
+ * Problem file being written: A and b are filled in place, in the mapped file.
+ */
+struct ProblemWriter
+{
+    static ErrorOr<ProblemWriter> create(const std::string & path, std::size_t dims);
+
+    double * a() const noexcept { return at(m_header->a_offset); }
+    double * b() const noexcept { return at(m_header->b_offset); }
+    std::size_t dims() const noexcept { return m_header->dims; }
+
+    /*
+     * Write the rest of the header and flush the file.
+     * Magic is written last, so files that were not finished are never loaded.
+     */
+    MaybeErrorText finish(double c, double min_eigenvalue, double max_eigenvalue);
+
+private:
+    explicit ProblemWriter(std::shared_ptr<MappedFile> file)
+        : m_file(std::move(file))
+        , m_header(static_cast<ProblemFileHeader *>(m_file->data()))
+    {}
+
+    double * at(std::uint64_t offset) const noexcept
+    {
+        return reinterpret_cast<double *>(static_cast<char *>(m_file->data()) + offset);
+    }
+
+private:
+    std::shared_ptr<MappedFile> m_file;
+    ProblemFileHeader * m_header;
+};
+
+/*
+ * Map problem file. The function refers to the mapped data, nothing is copied.
+ */
+ErrorOr<NFunction> load_problem(const std::string & path);
+
+/*
+ * Write function into problem file.
+ */
+MaybeErrorText save_problem(const std::string & path, const NFunction & func);
+
+} // namespace util
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Misc.h"
+#include "NFunction.h"
+#include "SparseMatrix.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <string>
+
+namespace util {
+
+enum class Spectrum
+{
+    Uniform,   // eigenvalues are uniformly distributed between the bounds
+    Geometric, // eigenvalues form geometric progression from min to max
+    Clustered, // eigenvalues are grouped around cluster centers, which form geometric progression
+};
+
+/*
+ * Parameters of a synthetic quadratic problem.
+ * Generated data is determined by the seed only: element i is calculated from (seed, i) by a counter-based generator,
+ * so the result does not depend on the number of threads filling it.
+ * The smallest and the largest eigenvalues are exactly min_eigenvalue and max_eigenvalue.
+ */
+struct ProblemSpec
+{
+    std::size_t dims = 0;
+    std::uint64_t seed = 0;
+    Spectrum spectrum = Spectrum::Uniform;
+    double min_eigenvalue = 1.;
+    double max_eigenvalue = 1000.;
+    std::size_t clusters = 4;    // for clustered spectrum
+    double cluster_width = 0.01; // relative half-width of a cluster
+    double b_range = 1.;         // elements of b are uniform in [-b_range, b_range]
+    double c = 0.;
+
+    ProblemSpec & with_condition_number(double cond) noexcept
+    {
+        max_eigenvalue = min_eigenvalue * cond;
+        return *this;
+    }
+};
+
+/*
+ * Check, that the problem can be generated.
+ */
+MaybeErrorText validate(const ProblemSpec & spec);
+
+/*
+ * Fill preallocated memory (e.g. a mapped file) with spec.dims eigenvalues of A and elements of b.
+ * If pool is given, the work is split between its threads and the calling one.
+ */
+MaybeErrorText generate_problem(const ProblemSpec & spec, double * a, double * b, ThreadPool * pool = nullptr);
+
+/*
+ * Generate problem in memory.
+ */
+ErrorOr<NFunction> generate_problem(const ProblemSpec & spec, ThreadPool * pool = nullptr);
+
+/*
+ * Generate problem right into the mapped problem file (see ProblemFile.h).
+ */
+MaybeErrorText generate_problem_file(const std::string & path, const ProblemSpec & spec, ThreadPool * pool = nullptr);
+
+/*
+ * Random sparse symmetric positive definite matrix.
+ * Each row gets up to per_row off-diagonal entries uniform in [-1, 1), at most bandwidth columns away from the diagonal,
+ * and the same entries are mirrored below the diagonal.
+ * The diagonal is an eigenvalue of spec's spectrum plus the sum of magnitudes of the row's off-diagonal entries,
+ * so by Gershgorin's theorem all eigenvalues are at least spec.min_eigenvalue.
+ * Rows are built independently: mirrored entries are regenerated from their counters, not looked up.
+ */
+ErrorOr<SparseMatrix> generate_sparse_spd(const ProblemSpec & spec, std::size_t per_row, std::size_t bandwidth, ThreadPool * pool = nullptr);
+
+} // namespace util
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace util {
+
+/*
+ * Launches a group of local worker processes.
+ * Rank 0 is the calling process itself, ranks 1..n-1 are forked from it,
+ * so they see all the data prepared before the launch.
+ * A forked child has only the thread, which forked it, so the group is not started from a process
+ * with several threads: locks held by the other threads would never be released in the children.
+ */
+struct ProcessGroup
+{
+    using Body = std::function<void(std::size_t rank)>;
+
+    explicit ProcessGroup(std::size_t processes)
+        : m_processes(processes)
+    {}
+
+    /*
+     * Run body in every process and wait for all of them to finish.
+     * Returns error text, if processes could not be started or some of them failed.
+     * An exception in a worker fails it; an exception in the calling process kills the workers and is rethrown.
+     */
+    std::optional<std::string> run(const Body & body);
+
+    /*
+     * Whether the other processes of the group are still running, as far as this one can tell:
+     * the calling process checks its workers, a worker checks the calling process.
+     * It is meant for watchdogs of waits inside of body (see ShmCommunicator::set_watchdog).
+     */
+    bool peers_alive() const;
+
+    std::size_t size() const noexcept { return m_processes; }
+
+private:
+    void kill_workers();
+
+private:
+    std::size_t m_processes;
+    pid_t m_parent = 0;
+    std::vector<pid_t> m_children; // in the calling process only
+    bool m_is_worker = false;
+};
+
+/*
+ * Number of threads of the current process, 0 if it is unknown.
+ */
+std::size_t thread_count();
+
+} // namespace util
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Misc.h"
+#include "ReplayData.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util {
+
+/*
+ * ReplayData split by kinds of records into tables of typed columns.
+ * Every table has the version of each record and its position in ReplayData, so that the original order can be restored.
+ * Vectors are stored as fixed-width blocks: row i is values[i * width, (i + 1) * width),
+ * where width is the greatest dimension; shorter vectors are padded with NaN and their dimensions are kept in dims.
+ * Comments are kept Arrow-style: row i is text[offsets[i], offsets[i + 1]).
+ */
+struct ReplayColumns
+{
+    struct Table
+    {
+        std::vector<std::uint32_t> versions;
+        std::vector<std::uint64_t> positions;
+
+        std::size_t rows() const noexcept { return versions.size(); }
+    };
+
+    struct Points : Table
+    {
+        std::vector<double> x, y;
+    };
+    struct Paraboles : Table
+    {
+        std::vector<double> a, b, c;
+    };
+    struct Segments : Table
+    {
+        std::vector<double> l, r;
+    };
+    struct Comments : Table
+    {
+        std::vector<std::uint64_t> offsets = {0};
+        std::string text;
+    };
+    struct Doubles : Table
+    {
+        std::vector<double> values;
+    };
+    struct Vectors : Table
+    {
+        std::uint32_t width = 0;
+        std::vector<std::uint32_t> dims;
+        std::vector<double> values;
+    };
+
+    Points points;
+    Paraboles paraboles;
+    Segments segments;
+    Comments comments;
+    Doubles doubles;
+    Vectors vectors;
+};
+
+ReplayColumns split_columns(const ReplayData & data);
+
+/*
+ * Binary columnar file, all numbers are native (byte order is checked by ENDIAN_MARK):
+ * header, then tables one after another. Table is
+ *     u32 name length, name, u32 number of columns, u64 number of rows, then columns.
+ * Column is
+ *     u32 name length, name, u8 type, u32 width, u64 size of data in bytes, data,
+ * where data of a numeric column is rows * width values, and data of a text column is rows + 1 u64 offsets followed by the characters.
+ * Data is padded with zeros before and after, so that it starts at offset from the file's start, which is a multiple of 8,
+ * and can be mapped as an array.
+ */
+struct ReplayFileHeader
+{
+    static constexpr char MAGIC[8] = {'N', 'D', 'M', 'R', 'P', 'L', 'A', 'Y'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t ENDIAN_MARK = 0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t tables;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(ReplayFileHeader) == 24, "replay file header layout changed");
+
+enum class ColumnType : std::uint8_t
+{
+    UInt32 = 0,
+    UInt64 = 1,
+    Float64 = 2,
+    Text = 3,
+};
+
+MaybeErrorText save_replay_columns(const std::string & path, const ReplayColumns & columns);
+
+/*
+ * One CSV file per non-empty table: prefix.point.csv, prefix.comment.csv, ...
+ * Numbers are written in the shortest form, that is read back exactly.
+ */
+MaybeErrorText save_replay_csv(const std::string & prefix, const ReplayColumns & columns);
+
+} // namespace util
@@ -4,6 +4,7 @@
 #include "Misc.h"
 #include "VersionedData.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iterator>
 #include <memory>
@@ -26,31 +27,111 @@ public:
     using VdDataPtr = std::unique_ptr<const VersionedData>;
     using iterator = std::vector<VdDataPtr>::const_iterator;
 
+    /*
+     * Consecutive records, e.g. all records of one version.
+     */
+    struct Range
+    {
+        iterator begin() const { return m_begin; }
+        iterator end() const { return m_end; }
+
+        std::size_t size() const noexcept { return static_cast<std::size_t>(m_end - m_begin); }
+        bool empty() const noexcept { return m_begin == m_end; }
+
+        const VersionedData & operator[](std::size_t idx) const noexcept { return *m_begin[idx]; }
+
+        iterator m_begin, m_end;
+    };
+
     iterator begin() const { return m_data.begin(); }
     iterator end() const { return m_data.end(); }
 
+    std::size_t size() const noexcept { return m_data.size(); }
+    bool empty() const noexcept { return m_data.empty(); }
+
+    const VersionedData & operator[](std::size_t idx) const noexcept { return *m_data[idx]; }
+
+    /*
+     * The greatest version recorded.
+     */
+    uint total_versions() const noexcept { return m_total_versions; }
+
+    /*
+     * All records of the version, in the order they were added.
+     * Versions without records and versions after the last one give empty ranges.
+     */
+    Range records_for(uint version) const noexcept { return records_in(version, version); }
+
+    /*
+     * Records of versions from first to last inclusive.
+     */
+    Range records_in(uint first, uint last) const noexcept
+    {
+        if (first > last) {
+            return {m_data.end(), m_data.end()};
+        }
+        return {m_data.begin() + version_start(first), m_data.begin() + version_start(last + 1)};
+    }
+
 
     template <class VdData>
     auto push_back(VdData && vd_data) -> std::enable_if_t<std::is_base_of_v<VersionedData, std::decay_t<VdData>>>
     {
         using ValueType = std::decay_t<VdData>;
 
-        m_data.emplace_back(std::make_unique<const ValueType>(std::forward<VdData>(vd_data)));
-        m_total_versions = std::max(m_total_versions, vd_data.version());
+        const auto pos = index(vd_data.version());
+        m_data.insert(m_data.begin() + pos, std::make_unique<const ValueType>(std::forward<VdData>(vd_data)));
     }
 
 
     template <class VdDataType, class... Args>
-    void emplace_back(Args &&... args) { m_data.emplace_back(std::make_unique<VdDataType>(std::forward<Args>(args)...)); }
+    void emplace_back(Args &&... args)
+    {
+        auto vd_data = std::make_unique<VdDataType>(std::forward<Args>(args)...);
+        const auto pos = index(vd_data->version());
+        m_data.insert(m_data.begin() + pos, std::move(vd_data));
+    }
 
     void clear()
     {
         m_data.clear();
+        m_version_starts.clear();
         m_total_versions = 0;
     }
 
+private:
+    /*
+     * Account the record in the version index and return the position to add it at.
+     * Methods record iterations one after another, so records normally go to the end;
+     * record of an earlier version (e.g. of a fallback run) goes after the other records of its version.
+     */
+    std::size_t index(uint version)
+    {
+        if (version + 1 < m_version_starts.size()) {
+            const std::size_t pos = m_version_starts[version + 1];
+            for (std::size_t v = version + 1; v < m_version_starts.size(); ++v) {
+                ++m_version_starts[v];
+            }
+            return pos;
+        }
+        while (m_version_starts.size() <= version) {
+            m_version_starts.push_back(m_data.size());
+        }
+        m_total_versions = std::max(m_total_versions, version);
+        return m_data.size();
+    }
+
+    /*
+     * Position of the first record with version not less than the given one.
+     */
+    std::size_t version_start(uint version) const noexcept
+    {
+        return version < m_version_starts.size() ? m_version_starts[version] : m_data.size();
+    }
+
 private:
     std::vector<VdDataPtr> m_data;
+    std::vector<std::size_t> m_version_starts; // m_version_starts[v] is the position of the first record of version v or later
     uint m_total_versions = 0;
 };
 
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include <pthread.h>
+
+namespace util {
+
+/*
+ * Anonymous memory region shared with processes forked after its creation.
+ */
+struct ShmRegion
+{
+    explicit ShmRegion(std::size_t size);
+    ~ShmRegion();
+
+    ShmRegion(const ShmRegion &) = delete;
+    ShmRegion & operator=(const ShmRegion &) = delete;
+
+    void * data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+
+    bool valid() const noexcept { return m_data != nullptr; }
+
+private:
+    void * m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+/*
+ * Reductions between a fixed number of processes, done through shared memory.
+ * Every process writes its partial values into its own slot, waits on a process-shared barrier
+ * and sums all slots in the same order, so all processes get bitwise equal results.
+ * Slots are double-buffered, so one barrier per reduction is enough.
+ *
+ * A process, which fails, must not leave the others waiting on the barrier forever:
+ * the group is aborted, when a process calls abort(), dies holding the barrier's lock,
+ * or when the watchdog of a waiting process reports, that some peer is gone.
+ * After that every barrier and reduction returns false at once.
+ */
+struct ShmCommunicator
+{
+    static constexpr std::size_t MAX_VALUES = 4; // max number of values reduced at once
+
+    explicit ShmCommunicator(std::size_t processes);
+    ~ShmCommunicator();
+
+    bool valid() const noexcept { return m_region.valid(); }
+
+    std::size_t size() const noexcept { return m_processes; }
+
+    /*
+     * Sum values[0..count) over all processes, result is written back into values.
+     * Must be called by every process in the same order.
+     * Returns false, if the group is aborted, values are undefined then.
+     */
+    bool allreduce_sum(std::size_t rank, double * values, std::size_t count);
+
+    bool allreduce_sum(std::size_t rank, double & value) { return allreduce_sum(rank, &value, 1); }
+
+    /*
+     * Wait until all processes arrive. Returns false, if the group is aborted.
+     */
+    bool barrier();
+
+    void abort() noexcept;
+    bool aborted() const noexcept;
+
+    /*
+     * While waiting on the barrier, watchdog is called every POLL_INTERVAL_MS; when it returns false,
+     * the group is aborted. It is set in every process separately, e.g. after fork.
+     */
+    void set_watchdog(std::function<bool()> watchdog) { m_watchdog = std::move(watchdog); }
+
+    static constexpr long POLL_INTERVAL_MS = 50;
+
+private:
+    struct Header
+    {
+        pthread_mutex_t mutex; // robust: owner's death is reported to the next locker
+        pthread_cond_t cond;
+        std::size_t arrived = 0;
+        std::size_t generation = 0; // number of completed barriers
+        bool aborted = false;
+    };
+
+    /*
+     * Lock the header's mutex; if its owner died, the group is aborted.
+     */
+    void lock() const noexcept;
+    void unlock() const noexcept;
+
+    Header & header() const noexcept { return *static_cast<Header *>(m_region.data()); }
+    double * slot(std::size_t parity, std::size_t rank) const noexcept;
+
+private:
+    std::size_t m_processes;
+    ShmRegion m_region;
+    std::size_t m_parity = 0; // every process keeps its own copy after fork
+    std::function<bool()> m_watchdog;
+};
+
+} // namespace util
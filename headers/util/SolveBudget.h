@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace util {
+
+/*
+ * Why the search stopped.
+ */
+enum class StopReason
+{
+    Converged,      // required precision is reached
+    MaxIterations,
+    MaxEvaluations,
+    Deadline,
+    Cancelled,
+    Failed,         // method is not applicable to the function, e.g. it has no unique minimum
+};
+
+inline std::string_view stop_reason_name(StopReason reason) noexcept
+{
+    switch (reason) {
+    case StopReason::Converged: return "converged";
+    case StopReason::MaxIterations: return "max iterations";
+    case StopReason::MaxEvaluations: return "max evaluations";
+    case StopReason::Deadline: return "deadline";
+    case StopReason::Cancelled: return "cancelled";
+    case StopReason::Failed: return "failed";
+    }
+    return "unknown";
+}
+
+/*
+ * Flag shared between copies: cancel() on any copy is seen by all of them.
+ * Searches check it at iteration boundaries, so cancellation is cooperative.
+ */
+struct CancellationToken
+{
+    CancellationToken()
+        : m_flag(std::make_shared<Flag>())
+    {}
+
+    /*
+     * Token, which is cancelled with this one, but can also be cancelled alone.
+     */
+    CancellationToken child() const
+    {
+        CancellationToken res;
+        res.m_flag->parent = m_flag;
+        return res;
+    }
+
+    void cancel() const noexcept { m_flag->cancelled.store(true, std::memory_order_relaxed); }
+    bool is_cancelled() const noexcept
+    {
+        for (const Flag * flag = m_flag.get(); flag != nullptr; flag = flag->parent.get()) {
+            if (flag->cancelled.load(std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Flag
+    {
+        std::atomic<bool> cancelled{false};
+        std::shared_ptr<const Flag> parent;
+    };
+
+    std::shared_ptr<Flag> m_flag;
+};
+
+/*
+ * Limits of one search. Unset max_iter means the default limit of the method, other unset limits do not restrict anything.
+ * Timeout is counted from the start of each search, so one budget can be reused; deadline is the same for all searches.
+ */
+struct SolveBudget
+{
+    using Clock = std::chrono::steady_clock;
+
+    SolveBudget() = default;
+    explicit SolveBudget(uint max_iter)
+        : max_iter(max_iter)
+    {}
+
+    SolveBudget & with_max_iter(uint iters) noexcept
+    {
+        max_iter = iters;
+        return *this;
+    }
+    SolveBudget & with_max_evals(std::size_t evals) noexcept
+    {
+        max_evals = evals;
+        return *this;
+    }
+    SolveBudget & with_deadline(Clock::time_point time) noexcept
+    {
+        deadline = time;
+        return *this;
+    }
+    SolveBudget & with_timeout(Clock::duration duration) noexcept
+    {
+        timeout = duration;
+        return *this;
+    }
+    SolveBudget & with_token(CancellationToken token)
+    {
+        cancel_token = std::move(token);
+        return *this;
+    }
+
+    /*
+     * Budget of the search starting now: unset max_iter is replaced by the method's default, timeout becomes a deadline.
+     */
+    SolveBudget start(uint default_max_iter) const
+    {
+        SolveBudget res = *this;
+        res.max_iter = max_iter.value_or(default_max_iter);
+        if (timeout) {
+            const auto end = Clock::now() + *timeout;
+            res.deadline = deadline ? std::min(*deadline, end) : end;
+            res.timeout.reset();
+        }
+        return res;
+    }
+
+    /*
+     * Reason to stop before iteration iter_num, when evals evaluations are already made; nullopt to go on.
+     * The clock is read only if there is a deadline.
+     */
+    std::optional<StopReason> check(uint iter_num, std::size_t evals) const noexcept
+    {
+        if (iter_num >= max_iter.value_or(std::numeric_limits<uint>::max())) {
+            return StopReason::MaxIterations;
+        }
+        if (evals >= max_evals) {
+            return StopReason::MaxEvaluations;
+        }
+        if (cancel_token && cancel_token->is_cancelled()) {
+            return StopReason::Cancelled;
+        }
+        if (deadline && Clock::now() >= *deadline) {
+            return StopReason::Deadline;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<uint> max_iter;
+    std::size_t max_evals = std::numeric_limits<std::size_t>::max();
+    std::optional<Clock::time_point> deadline;
+    std::optional<Clock::duration> timeout;
+    std::optional<CancellationToken> cancel_token;
+};
+
+} // namespace util
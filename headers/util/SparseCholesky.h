@@ -0,0 +1,51 @@
+#pragma once
+
+#include "DiagMatrix.h"
+#include "Misc.h"
+#include "SparseMatrix.h"
+#include "Vector.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+/*
+ * Cholesky factorization P A P^T = L L^T of a sparse symmetric positive definite matrix.
+ * It is made once per matrix and then solves A x = b for any number of b, each solve is two triangular sweeps.
+ * Rows and columns are permuted by minimum degree ordering, which reduces fill of L.
+ * Pattern of L is found from the elimination tree before the numeric factorization, which computes L row by row.
+ * L is stored by columns, each column starts with its diagonal element.
+ * Diagonal matrix is its own factor, it is neither ordered nor analyzed, and solves are divisions.
+ */
+struct SparseCholesky
+{
+    /*
+     * A must be symmetric: the pattern of both triangles is used for the ordering, values are taken below the diagonal.
+     */
+    static ErrorOr<SparseCholesky> factorize(const SparseMatrix & a);
+    static ErrorOr<SparseCholesky> factorize(const DiagMatrix & a);
+
+    Vector solve(const Vector & b) const;
+
+    std::size_t dims() const noexcept { return m_dims; }
+    bool is_diagonal() const noexcept { return m_col_starts.empty(); }
+    /*
+     * Number of stored elements of L.
+     */
+    std::size_t factor_nnz() const noexcept { return m_values.size(); }
+
+private:
+    SparseCholesky() = default;
+
+    static ErrorOr<SparseCholesky> factorize_diag(std::vector<double> diag);
+
+private:
+    std::size_t m_dims = 0;
+    std::vector<std::uint32_t> m_perm;     // row k of P A P^T is row m_perm[k] of A
+    std::vector<std::size_t> m_col_starts; // column j of L is at [m_col_starts[j], m_col_starts[j + 1]), empty for diagonal A
+    std::vector<std::uint32_t> m_rows;
+    std::vector<double> m_values;          // elements of L, or the diagonal of A itself
+};
+
+} // namespace util
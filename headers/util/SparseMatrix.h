@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Vector.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+/*
+ * Square sparse matrix in compressed sparse row format:
+ * entries of row i are at positions [row_starts[i], row_starts[i + 1]) of cols and values,
+ * sorted by column.
+ */
+struct SparseMatrix
+{
+    SparseMatrix(std::vector<std::size_t> row_starts, std::vector<std::uint32_t> cols, std::vector<double> values)
+        : m_row_starts(std::move(row_starts))
+        , m_cols(std::move(cols))
+        , m_values(std::move(values))
+    {
+        assert(!m_row_starts.empty() && m_row_starts.back() == m_cols.size() && m_cols.size() == m_values.size() && "broken sparse matrix");
+    }
+
+    Vector operator*(const Vector & vec) const
+    {
+        assert(dims() == vec.dims() && "Matrix by Vector dim mismatch");
+        std::vector<double> res(dims());
+        for (std::size_t i = 0; i < dims(); ++i) {
+            double sum = 0.;
+            for (std::size_t pos = m_row_starts[i]; pos < m_row_starts[i + 1]; ++pos) {
+                sum += m_values[pos] * vec[m_cols[pos]];
+            }
+            res[i] = sum;
+        }
+        return Vector(std::move(res));
+    }
+
+    /*
+     * Element (row, col), zero if it is not stored.
+     */
+    double at(std::size_t row, std::size_t col) const noexcept
+    {
+        for (std::size_t pos = m_row_starts[row]; pos < m_row_starts[row + 1]; ++pos) {
+            if (m_cols[pos] == col) {
+                return m_values[pos];
+            }
+        }
+        return 0.;
+    }
+
+    Vector diag() const
+    {
+        std::vector<double> res(dims());
+        for (std::size_t i = 0; i < dims(); ++i) {
+            res[i] = at(i, i);
+        }
+        return Vector(std::move(res));
+    }
+
+    bool is_diagonal() const noexcept
+    {
+        for (std::size_t i = 0; i < dims(); ++i) {
+            for (std::size_t pos = m_row_starts[i]; pos < m_row_starts[i + 1]; ++pos) {
+                if (m_cols[pos] != i && m_values[pos] != 0.) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::size_t dims() const noexcept { return m_row_starts.size() - 1; }
+    std::size_t nnz() const noexcept { return m_values.size(); }
+
+    const std::vector<std::size_t> & row_starts() const noexcept { return m_row_starts; }
+    const std::vector<std::uint32_t> & cols() const noexcept { return m_cols; }
+    const std::vector<double> & values() const noexcept { return m_values; }
+
+private:
+    std::vector<std::size_t> m_row_starts;
+    std::vector<std::uint32_t> m_cols;
+    std::vector<double> m_values;
+};
+
+} // namespace util
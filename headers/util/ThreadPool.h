@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+
+/*
+ * Fixed-size pool of worker threads executing submitted tasks in FIFO order.
+ */
+struct ThreadPool
+{
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    /*
+     * Schedule func for execution, returns future for its result.
+     */
+    template <class Func>
+    auto submit(Func && func) -> std::future<std::invoke_result_t<std::decay_t<Func>>>
+    {
+        using Res = std::invoke_result_t<std::decay_t<Func>>;
+
+        auto task = std::make_shared<std::packaged_task<Res()>>(std::forward<Func>(func));
+        auto res = task->get_future();
+        push([task] { (*task)(); });
+        return res;
+    }
+
+    /*
+     * Call func(i) for each i in [0, count) and wait for all calls to finish.
+     * The calling thread takes part in the work too, so it is fine to call it with an empty pool.
+     * If a call throws, the indices not yet taken are skipped, and the first exception is rethrown
+     * after all the helpers are done: they use func and the caller's state until then.
+     */
+    template <class Func>
+    void parallel_for(std::size_t count, Func && func)
+    {
+        auto next = std::make_shared<std::atomic<std::size_t>>(0);
+        auto work = [next, count, &func] {
+            try {
+                for (std::size_t i = (*next)++; i < count; i = (*next)++) {
+                    func(i);
+                }
+            } catch (...) {
+                next->store(count);
+                throw;
+            }
+        };
+
+        const std::size_t helpers = std::min(size(), count > 0 ? count - 1 : 0);
+        std::vector<std::future<void>> done;
+        std::exception_ptr error;
+        try {
+            done.reserve(helpers);
+            for (std::size_t i = 0; i < helpers; ++i) {
+                done.emplace_back(submit(work));
+            }
+            work();
+        } catch (...) {
+            error = std::current_exception();
+            next->store(count);
+        }
+        for (auto & fut : done) {
+            try {
+                fut.get();
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::size_t size() const noexcept { return m_workers.size(); }
+
+private:
+    void push(std::function<void()> task);
+    void worker_loop();
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stop = false;
+};
+
+} // namespace util
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Misc.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace util {
+
+/*
+ * Timeline of solver execution in Chrome trace-event format, to be viewed in Perfetto or chrome://tracing.
+ * Spans are recorded into buffers of the threads that made them, without locks,
+ * so concurrent searches do not interfere. A disabled span costs one relaxed load.
+ * Buffers are kept after their threads exit; each thread records at most MAX_TRACE_EVENTS spans, the rest are dropped.
+ */
+inline constexpr std::size_t MAX_TRACE_EVENTS = 1 << 22;
+
+namespace detail {
+extern std::atomic<bool> tracing_enabled;
+} // namespace detail
+
+inline bool tracing_enabled() noexcept { return detail::tracing_enabled.load(std::memory_order_relaxed); }
+void enable_tracing(bool enabled) noexcept;
+
+/*
+ * Timestamp of spans in ticks: time stamp counter on x86, which is read without a system call,
+ * and nanoseconds of steady clock elsewhere. Ticks are converted to time only when the trace is written.
+ */
+inline std::uint64_t trace_clock() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/*
+ * Record span [begin, end) of the calling thread, in ticks of trace_clock().
+ * Name must be a string literal (or live as long as the trace).
+ */
+void record_trace_span(const char * name, std::uint64_t begin, std::uint64_t end) noexcept;
+
+/*
+ * Name of the calling thread in the trace.
+ */
+void set_trace_thread_name(std::string name);
+
+/*
+ * Write all recorded spans as Chrome trace JSON. Spans being recorded concurrently may be missed, but never torn.
+ */
+std::string chrome_trace_json();
+MaybeErrorText save_chrome_trace(const std::string & path);
+
+/*
+ * Span from construction to destruction.
+ */
+struct TraceSpan
+{
+    explicit TraceSpan(const char * name) noexcept
+        : m_name(tracing_enabled() ? name : nullptr)
+        , m_begin(m_name ? trace_clock() : 0)
+    {}
+
+    ~TraceSpan()
+    {
+        if (m_name) {
+            record_trace_span(m_name, m_begin, trace_clock());
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan & operator=(const TraceSpan &) = delete;
+
+private:
+    const char * m_name;
+    std::uint64_t m_begin;
+};
+
+} // namespace util
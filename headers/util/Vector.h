@@ -5,51 +5,104 @@
 #include <functional>
 #include <numeric>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 
 namespace util {
 
 struct QuadMatrix;
 
-struct Vector
+template <class T>
+struct BasicDiagMatrix;
+
+/*
+ * Vector with elements of type T stored.
+ * Whatever T is, dot products are accumulated in double.
+ */
+template <class T>
+struct BasicVector
 {
-    friend struct DiagMatrix;
+    template <class U>
+    friend struct BasicVector;
+    template <class U>
+    friend struct BasicDiagMatrix;
     friend struct QuadMatrix;
 
-    explicit Vector(std::size_t dims)
-        : m_data(dims, 0.)
+    using value_type = T;
+
+    explicit BasicVector(std::size_t dims)
+        : m_data(dims, T(0))
     {}
 
-    explicit Vector(std::vector<double> vec)
+    explicit BasicVector(std::vector<T> vec)
         : m_data(std::move(vec))
     {}
 
-    double operator*(const Vector & rhs) const noexcept
+    /*
+     * Convert vector of another precision.
+     */
+    template <class U, class = std::enable_if_t<!std::is_same_v<T, U>>>
+    explicit BasicVector(const BasicVector<U> & other)
+        : m_data(other.m_data.begin(), other.m_data.end())
+    {}
+
+    double operator*(const BasicVector & rhs) const noexcept { return dot(rhs); }
+
+    /*
+     * Dot product with vector of any precision, accumulated in double.
+     */
+    template <class U>
+    double dot(const BasicVector<U> & rhs) const noexcept
     {
-        return std::transform_reduce(m_data.begin(), m_data.end(), rhs.m_data.begin(), 0., std::plus<double>{}, std::multiplies<double>{});
+        return std::transform_reduce(m_data.begin(), m_data.end(), rhs.m_data.begin(), 0., std::plus<double>{}, [](T lhs, U rhs) {
+            return static_cast<double>(lhs) * static_cast<double>(rhs);
+        });
     }
 
-    Vector operator*(double scalar) const noexcept
+    BasicVector operator*(double scalar) const noexcept
     {
         std::vector res(m_data);
-        std::for_each(res.begin(), res.end(), [scalar](double & x) { x *= scalar; });
-        return Vector{std::move(res)};
+        std::for_each(res.begin(), res.end(), [scalar](T & x) { x = static_cast<T>(x * scalar); });
+        return BasicVector{std::move(res)};
     }
 
-    friend Vector operator*(double scalar, const Vector & vec) noexcept { return vec * scalar; }
+    friend BasicVector operator*(double scalar, const BasicVector & vec) noexcept { return vec * scalar; }
 
-    Vector operator+(const Vector & rhs) const noexcept { return plus_minus(rhs, std::plus<double>{}); }
+    BasicVector operator+(const BasicVector & rhs) const noexcept { return plus_minus(rhs, std::plus<T>{}); }
 
-    Vector operator-(const Vector & rhs) const noexcept { return plus_minus(rhs, std::minus<double>{}); }
+    BasicVector operator-(const BasicVector & rhs) const noexcept { return plus_minus(rhs, std::minus<T>{}); }
+
+    /*
+     * this += alpha * vec, where vec may have another precision.
+     * Calculation is done in double, result is rounded to T.
+     */
+    template <class U>
+    BasicVector & add_scaled(double alpha, const BasicVector<U> & vec) noexcept
+    {
+        assert(dims() == vec.dims() && "Vector::add_scaled dimension mismatch");
+        std::transform(m_data.begin(), m_data.end(), vec.m_data.begin(), m_data.begin(), [alpha](T lhs, U rhs) {
+            return static_cast<T>(lhs + alpha * rhs);
+        });
+        return *this;
+    }
+
+    const T & operator[](std::size_t idx) const noexcept { return m_data[idx]; }
+
+    const T * data() const noexcept { return m_data.data(); }
+
+    /*
+     * Take the elements out of the vector.
+     */
+    std::vector<T> take_data() && noexcept { return std::move(m_data); }
 
     std::size_t dims() const noexcept { return m_data.size(); }
 
     double length_pow2() const noexcept { return *this * *this; }
 
-    friend std::ostream & operator<<(std::ostream & out, const Vector & vec)
+    friend std::ostream & operator<<(std::ostream & out, const BasicVector & vec)
     {
         out << "{";
-        std::for_each(vec.m_data.begin(), vec.m_data.end(), [&out, first(true)](double x) mutable {
+        std::for_each(vec.m_data.begin(), vec.m_data.end(), [&out, first(true)](T x) mutable {
             if (!first) {
                 out << ", ";
             } else {
@@ -63,15 +116,18 @@ struct Vector
 
 private:
     template <class Func>
-    Vector plus_minus(const Vector & rhs, Func && to_apply) const noexcept
+    BasicVector plus_minus(const BasicVector & rhs, Func && to_apply) const noexcept
     {
         assert(dims() == rhs.dims() && "Vector::plus_minus dimension mismatch");
-        std::vector<double> res(dims());
+        std::vector<T> res(dims());
         std::transform(m_data.begin(), m_data.end(), rhs.m_data.begin(), res.begin(), std::forward<Func>(to_apply));
-        return Vector{std::move(res)};
+        return BasicVector{std::move(res)};
     }
 
 private:
-    std::vector<double> m_data;
+    std::vector<T> m_data;
 };
+
+using Vector = BasicVector<double>;
+
 } // namespace util
@@ -7,7 +7,9 @@
 
 namespace util {
 
-struct Vector;
+template <class T>
+struct BasicVector;
+using Vector = BasicVector<double>;
 
 
 #define M(vd_data_name) vd_data_name##Kind,
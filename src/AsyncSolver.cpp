@@ -0,0 +1,162 @@
+#include "AsyncSolver.h"
+
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace min_nd {
+
+namespace {
+
+/*
+ * Solve request, the search is stopped by token too, if it is given.
+ */
+SolveResult solve(const SolveRequest & request, const util::CancellationToken * token)
+{
+    auto methods = make_methods(request.method, request.sd_method, request.eps, request.options);
+    if (auto err = std::get_if<std::string>(&methods)) {
+        return std::move(*err);
+    }
+    if (request.start && request.start->dims() != request.func->dims()) {
+        return "start point has " + std::to_string(request.start->dims()) + " coordinates, problem has " + std::to_string(request.func->dims());
+    }
+
+    auto & searcher = *std::get<MethodPair>(methods).nd_method;
+    searcher.set_func(request.func);
+    searcher.set_start_point(request.start);
+    if (request.budget || token) {
+        auto budget = request.budget.value_or(searcher.budget());
+        if (token) {
+            budget.with_token(*token);
+        }
+        searcher.set_budget(std::move(budget));
+    }
+    return searcher.find_min();
+}
+
+/*
+ * State of one portfolio, shared by its racing tasks.
+ */
+struct PortfolioRace
+{
+    PortfolioRace(std::size_t racers, double race_eps, util::CancellationToken race_token)
+        : remaining(racers)
+        , eps(race_eps)
+        , token(std::move(race_token))
+    {}
+
+    /*
+     * Methods judge convergence by their own criteria (e.g. Nelder-Mead by the simplex),
+     * so the race checks the residual itself before it stops the others.
+     */
+    bool solved(const SearchRes & res) const noexcept
+    {
+        return res.stop_reason == util::StopReason::Converged && std::isfinite(res.min) && res.residual <= eps;
+    }
+
+    /*
+     * Account result of a finished racer. The answer is given on the first solved result,
+     * or when the last racer finishes.
+     */
+    void finish(const std::string & method, SolveResult result)
+    {
+        std::lock_guard guard(mutex);
+        --remaining;
+        if (answered) {
+            return;
+        }
+        const auto * found = std::get_if<SearchRes>(&result);
+        if (found && solved(*found)) {
+            answered = true;
+            token.cancel();
+            promise.set_value({std::move(result), method});
+            return;
+        }
+        const auto * best_found = best ? std::get_if<SearchRes>(&best->result) : nullptr;
+        if (!best || (found && (!best_found || (std::isfinite(found->min) && (!std::isfinite(best_found->min) || found->min < best_found->min))))) {
+            best = PortfolioResult{std::move(result), method};
+        }
+        if (remaining == 0) {
+            answered = true;
+            promise.set_value(std::move(*best));
+        }
+    }
+
+    std::mutex mutex;
+    std::promise<PortfolioResult> promise;
+    std::size_t remaining; // racers, which have not finished yet
+    const double eps;      // required length of the gradient
+    bool answered = false;
+    std::optional<PortfolioResult> best; // of the finished racers, while none solved the problem
+    util::CancellationToken token;       // cancels the racers
+};
+
+} // anonymous namespace
+
+SolveResult solve(const SolveRequest & request)
+{
+    return solve(request, nullptr);
+}
+
+std::future<SolveResult> AsyncSolver::submit(SolveRequest request)
+{
+    return m_pool.submit([request = std::move(request)] { return solve(request); });
+}
+
+std::future<SolveResult> AsyncSolver::submit(SolveRequest request, SolveCallback on_done)
+{
+    return m_pool.submit([request = std::move(request), on_done = std::move(on_done)] {
+        auto res = solve(request);
+        on_done(res);
+        return res;
+    });
+}
+
+std::vector<std::future<SolveResult>> AsyncSolver::submit_all(std::vector<SolveRequest> requests)
+{
+    std::vector<std::future<SolveResult>> res;
+    res.reserve(requests.size());
+    for (auto & request : requests) {
+        res.emplace_back(submit(std::move(request)));
+    }
+    return res;
+}
+
+void AsyncSolver::submit_all(std::vector<SolveRequest> requests, std::function<void(std::size_t, const SolveResult &)> on_done)
+{
+    auto shared_on_done = std::make_shared<std::function<void(std::size_t, const SolveResult &)>>(std::move(on_done));
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        m_pool.submit([i, shared_on_done, request = std::move(requests[i])] { (*shared_on_done)(i, solve(request)); });
+    }
+}
+
+std::future<PortfolioResult> AsyncSolver::submit_portfolio(SolveRequest request, std::vector<std::string> methods)
+{
+    if (methods.empty()) {
+        std::promise<PortfolioResult> no_methods;
+        no_methods.set_value({std::string("no methods to race"), {}});
+        return no_methods.get_future();
+    }
+
+    const std::optional<util::CancellationToken> caller_token = request.budget ? request.budget->cancel_token : std::nullopt;
+    auto race = std::make_shared<PortfolioRace>(methods.size(), request.eps, caller_token ? caller_token->child() : util::CancellationToken());
+    auto res = race->promise.get_future();
+    for (auto & method : methods) {
+        SolveRequest racer = request;
+        racer.method = std::move(method);
+        m_pool.submit([race, racer = std::move(racer)] { race->finish(racer.method, solve(racer, &race->token)); });
+    }
+    return res;
+}
+
+#ifdef ND_MINIMIZATION_HAS_COROUTINES
+void SolveAwaitable::await_suspend(std::coroutine_handle<> handle)
+{
+    m_solver.m_pool.submit([this, handle] {
+        m_result.emplace(solve(m_request));
+        handle.resume();
+    });
+}
+#endif
+
+} // namespace min_nd
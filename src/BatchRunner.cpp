@@ -0,0 +1,363 @@
+#include "BatchRunner.h"
+
+#include "MethodFactory.h"
+
+#include "util/PerfCounters.h"
+#include "util/ProblemFile.h"
+#include "util/ReplayColumns.h"
+#include "util/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+
+namespace min_nd {
+
+namespace {
+
+/*
+ * {"hardware": true, "mat_vec": {"cycles": ..., "instructions": ..., "llc_misses": ..., "bytes": ..., "time_ns": ..., "entries": ...,
+ *  "cycles_per_iter": ..., "instructions_per_iter": ..., "bytes_per_iter": ..., "instructions_per_byte": ...}, "vector_ops": {...}, ...}
+ * Without hardware counters only time and entries are written.
+ */
+void write_profile(std::string & out, const util::PhaseStats & stats, std::size_t iterations)
+{
+    auto member = [&out](std::string_view name, double value) {
+        out += ",\"";
+        out += name;
+        out += "\":";
+        util::write_json(out, value);
+    };
+    const double iters = static_cast<double>(iterations);
+
+    out += "{\"hardware\":";
+    out += stats.hardware ? "true" : "false";
+    for (std::size_t i = 0; i < util::PHASE_COUNT; ++i) {
+        const auto & phase = stats.phases[i];
+        out += ",\"";
+        out += util::phase_name(static_cast<util::Phase>(i));
+        out += "\":{\"time_ns\":";
+        util::write_json(out, static_cast<double>(phase.time_ns));
+        member("entries", static_cast<double>(phase.entries));
+        if (stats.hardware) {
+            const double cycles = static_cast<double>(phase.cycles);
+            const double instructions = static_cast<double>(phase.instructions);
+            const double bytes = static_cast<double>(phase.bytes());
+            member("cycles", cycles);
+            member("instructions", instructions);
+            member("llc_misses", static_cast<double>(phase.llc_misses));
+            member("bytes", bytes);
+            member("cycles_per_iter", cycles / iters);
+            member("instructions_per_iter", instructions / iters);
+            member("bytes_per_iter", bytes / iters);
+            member("instructions_per_byte", instructions / bytes);
+        }
+        out += '}';
+    }
+    out += '}';
+}
+
+/*
+ * Path ending with ".csv" is a prefix of CSV files, anything else is a binary columnar file (see util/ReplayColumns.h).
+ */
+util::MaybeErrorText save_replay(const std::string & path, const util::ReplayData & data)
+{
+    constexpr std::string_view csv = ".csv";
+    const auto columns = util::split_columns(data);
+    if (path.size() > csv.size() && path.compare(path.size() - csv.size(), csv.size(), csv) == 0) {
+        return util::save_replay_csv(path.substr(0, path.size() - csv.size()), columns);
+    }
+    return util::save_replay_columns(path, columns);
+}
+
+} // anonymous namespace
+
+util::ErrorOr<BatchJob> parse_batch_job(std::string_view line)
+{
+    auto parsed = util::parse_json(line);
+    if (auto err = std::get_if<std::string>(&parsed)) {
+        return "bad JSON: " + *err;
+    }
+    const auto & doc = std::get<util::JsonValue>(parsed);
+    if (!doc.get_if<util::JsonObject>()) {
+        return std::string("job must be a JSON object");
+    }
+
+    BatchJob job;
+    auto get_string = [&doc](const char * key, std::string & to, bool required) -> util::MaybeErrorText {
+        const auto * member = doc.find(key);
+        if (!member) {
+            return required ? std::optional("missing \"" + std::string(key) + "\"") : std::nullopt;
+        }
+        if (auto str = member->get_if<std::string>()) {
+            to = *str;
+            return std::nullopt;
+        }
+        return "\"" + std::string(key) + "\" must be a string";
+    };
+    if (auto err = get_string("problem", job.problem, true)) {
+        return std::move(*err);
+    }
+    if (auto err = get_string("method", job.method, true)) {
+        return std::move(*err);
+    }
+    if (auto err = get_string("sd_method", job.sd_method, false)) {
+        return std::move(*err);
+    }
+    if (auto err = get_string("replay", job.replay, false)) {
+        return std::move(*err);
+    }
+
+    if (const auto * id = doc.find("id")) {
+        job.id = *id;
+    }
+    if (const auto * eps = doc.find("eps")) {
+        if (!eps->get_if<double>() || !(*eps->get_if<double>() > 0)) {
+            return std::string("\"eps\" must be a positive number");
+        }
+        job.eps = *eps->get_if<double>();
+    }
+    for (auto [key, flag] : {std::pair{"with_point", &job.with_point}, {"profile", &job.profile}}) {
+        if (const auto * member = doc.find(key)) {
+            if (!member->get_if<bool>()) {
+                return "\"" + std::string(key) + "\" must be a boolean";
+            }
+            *flag = *member->get_if<bool>();
+        }
+    }
+    for (auto [key, limit] : {std::pair{"max_iter", &job.max_iter}, {"max_evals", &job.max_evals}, {"timeout_ms", &job.timeout_ms}}) {
+        if (const auto * member = doc.find(key)) {
+            if (!member->get_if<double>() || !(*member->get_if<double>() >= 0)) {
+                return "\"" + std::string(key) + "\" must be a non-negative number";
+            }
+            *limit = *member->get_if<double>();
+        }
+    }
+    if (const auto * parallel = doc.find("parallel")) {
+        if (!parallel->get_if<double>() || !(*parallel->get_if<double>() >= 1)) {
+            return std::string("\"parallel\" must be a positive number");
+        }
+        job.parallel = static_cast<uint>(std::min(*parallel->get_if<double>(), 1e6));
+    }
+    if (const auto * start = doc.find("start")) {
+        const auto * arr = start->get_if<util::JsonArray>();
+        if (!arr) {
+            return std::string("\"start\" must be an array of numbers");
+        }
+        std::vector<double> coords;
+        coords.reserve(arr->size());
+        for (const auto & coord : *arr) {
+            if (!coord.get_if<double>()) {
+                return std::string("\"start\" must be an array of numbers");
+            }
+            coords.push_back(*coord.get_if<double>());
+        }
+        job.start.emplace(std::move(coords));
+    }
+    return job;
+}
+
+util::MaybeErrorText BatchRunner::run(std::istream & in, util::BufferedWriter & out)
+{
+    const std::size_t window = std::max<std::size_t>(m_options.window, 1);
+
+    /*
+     * Ordered output: futures are kept in the input order, the oldest one is waited for when the window is full.
+     * Unordered output: workers write results themselves, the reader waits while the window is full.
+     */
+    std::deque<std::future<std::string>> pending;
+    std::mutex out_mutex;
+    std::condition_variable slot_freed;
+    std::size_t in_flight = 0;
+    util::ThreadPool pool(std::max<std::size_t>(m_options.threads, 1)); // declared last to be joined first
+
+    std::string line;
+    std::size_t seq = 0;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        const std::size_t job_seq = seq++;
+
+        if (m_options.ordered) {
+            if (pending.size() >= window) {
+                out.write(pending.front().get());
+                pending.pop_front();
+            }
+            pending.push_back(pool.submit([this, job_seq, text = std::move(line)] { return try_run_job(job_seq, text); }));
+        } else {
+            std::unique_lock lock(out_mutex);
+            slot_freed.wait(lock, [&] { return in_flight < window; });
+            ++in_flight;
+            lock.unlock();
+
+            pool.submit([&, job_seq, text = std::move(line)] {
+                /*
+                 * The slot is freed even if writing throws, otherwise the final wait would never end.
+                 */
+                struct SlotRelease
+                {
+                    std::size_t & in_flight;
+                    std::condition_variable & slot_freed;
+                    ~SlotRelease()
+                    {
+                        --in_flight;
+                        slot_freed.notify_one();
+                    }
+                };
+                const auto res = try_run_job(job_seq, text);
+                std::lock_guard guard(out_mutex);
+                SlotRelease release{in_flight, slot_freed};
+                out.write(res);
+            });
+        }
+        line.clear();
+    }
+
+    for (; !pending.empty(); pending.pop_front()) {
+        out.write(pending.front().get());
+    }
+    std::unique_lock lock(out_mutex);
+    slot_freed.wait(lock, [&] { return in_flight == 0; });
+    return out.flush();
+}
+
+std::string BatchRunner::try_run_job(std::size_t seq, const std::string & line)
+{
+    try {
+        return run_job(seq, line);
+    } catch (const std::exception & e) {
+        std::string res = "{\"seq\":" + std::to_string(seq) + ",\"error\":";
+        util::write_json(res, std::string_view(e.what()));
+        return res += "}\n";
+    } catch (...) {
+        return "{\"seq\":" + std::to_string(seq) + ",\"error\":\"unknown exception\"}\n";
+    }
+}
+
+std::string BatchRunner::run_job(std::size_t seq, const std::string & line)
+{
+    std::string res = "{\"seq\":" + std::to_string(seq);
+    auto finish_with_error = [&res](const std::string & err) {
+        res += ",\"error\":";
+        util::write_json(res, std::string_view(err));
+        res += "}\n";
+        return res;
+    };
+
+    auto parsed = parse_batch_job(line);
+    if (auto err = std::get_if<std::string>(&parsed)) {
+        return finish_with_error(*err);
+    }
+    const auto & job = std::get<BatchJob>(parsed);
+    res += ",\"id\":";
+    util::write_json(res, job.id);
+
+    auto func = load_problem(job.problem);
+    if (auto err = std::get_if<std::string>(&func)) {
+        return finish_with_error(*err);
+    }
+    auto methods = make_methods(job.method, job.sd_method, job.eps, MethodOptions{job.parallel, m_eval_pool.get()});
+    if (auto err = std::get_if<std::string>(&methods)) {
+        return finish_with_error(*err);
+    }
+    auto & searcher = *std::get<MethodPair>(methods).nd_method;
+    auto & nfunc = std::get<util::NFunctionHandle>(func);
+    if (job.start && job.start->dims() != nfunc->dims()) {
+        return finish_with_error("start point has " + std::to_string(job.start->dims()) + " coordinates, problem has " + std::to_string(nfunc->dims()));
+    }
+
+    util::SolveBudget budget;
+    if (job.max_iter) {
+        budget.with_max_iter(static_cast<uint>(std::min(*job.max_iter, 1e9)));
+    }
+    if (job.max_evals) {
+        budget.with_max_evals(static_cast<std::size_t>(std::min(*job.max_evals, 1e18)));
+    }
+    if (job.timeout_ms) {
+        budget.with_timeout(std::chrono::duration_cast<util::SolveBudget::Clock::duration>(std::chrono::duration<double, std::milli>(*job.timeout_ms)));
+    }
+
+    searcher.set_func(std::move(nfunc));
+    searcher.set_start_point(job.start);
+    searcher.set_budget(std::move(budget));
+    searcher.set_profiling(job.profile);
+    const auto started = std::chrono::steady_clock::now();
+    util::MaybeErrorText replay_err;
+    auto search = [&]() -> SearchRes {
+        if (job.replay.empty()) {
+            return searcher.find_min();
+        }
+        auto traced = searcher.find_min_traced();
+        replay_err = save_replay(job.replay, traced.replay_data);
+        return traced;
+    };
+    const auto found = search();
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+    if (replay_err) {
+        return finish_with_error(*replay_err);
+    }
+
+    res += ",\"method\":";
+    util::write_json(res, searcher.method_name());
+    res += ",\"stop_reason\":";
+    util::write_json(res, util::stop_reason_name(found.stop_reason));
+    res += ",\"min\":";
+    util::write_json(res, found.min);
+    res += ",\"residual\":";
+    util::write_json(res, found.residual);
+    res += ",\"time_ms\":";
+    util::write_json(res, elapsed.count());
+    if (job.with_point) {
+        res += ",\"min_point\":[";
+        for (std::size_t i = 0; i < found.min_point.dims(); ++i) {
+            if (i > 0) {
+                res += ',';
+            }
+            util::write_json(res, found.min_point[i]);
+        }
+        res += ']';
+    }
+    if (found.profile) {
+        res += ",\"profile\":";
+        write_profile(res, *found.profile, found.history.total());
+    }
+    res += "}\n";
+    return res;
+}
+
+/*
+ * Problems are cached by path: jobs share the loaded function,
+ * so repeated jobs on the same problem neither reread nor copy it.
+ */
+util::ErrorOr<util::NFunctionHandle> BatchRunner::load_problem(const std::string & path)
+{
+    {
+        std::lock_guard guard(m_problems_mutex);
+        if (auto it = m_problems.find(path); it != m_problems.end()) {
+            return it->second;
+        }
+    }
+
+    auto loaded = util::load_problem(path);
+    if (auto err = std::get_if<std::string>(&loaded)) {
+        return std::move(*err);
+    }
+    util::NFunctionHandle func = std::make_shared<const util::NFunction>(std::move(std::get<util::NFunction>(loaded)));
+    if (m_options.problems_cached == 0) {
+        return func;
+    }
+
+    std::lock_guard guard(m_problems_mutex);
+    if (m_problems.emplace(path, func).second) {
+        m_problems_order.push_back(path);
+        if (m_problems_order.size() > m_options.problems_cached) {
+            m_problems.erase(m_problems_order.front());
+            m_problems_order.pop_front();
+        }
+    }
+    return func;
+}
+
+} // namespace min_nd
@@ -0,0 +1,79 @@
+#include "MethodFactory.h"
+
+#include "nd_methods/ConjugateGrad.h"
+#include "nd_methods/DirectSolver.h"
+#include "nd_methods/DistributedConjugateGrad.h"
+#include "nd_methods/FastestDescent.h"
+#include "nd_methods/Gradient.h"
+#include "nd_methods/MixedConjugateGrad.h"
+#include "nd_methods/NelderMead.h"
+#include "nd_methods/PipelinedConjugateGrad.h"
+#include "sd_methods/Brent.h"
+#include "sd_methods/BrentDeriv.h"
+#include "sd_methods/Cubic.h"
+#include "sd_methods/Dichotomy.h"
+#include "sd_methods/Fibonacci.h"
+#include "sd_methods/Golden.h"
+#include "sd_methods/Parabole.h"
+
+#include <string>
+
+namespace min_nd {
+
+std::unique_ptr<min1d::MinSearcher> make_sd_method(std::string_view name, double eps)
+{
+    if (name == "golden") {
+        return std::make_unique<min1d::Golden>(eps);
+    } else if (name == "fibonacci") {
+        return std::make_unique<min1d::Fibonacci>(eps);
+    } else if (name == "dichotomy") {
+        return std::make_unique<min1d::Dichotomy>(eps / 4, eps);
+    } else if (name == "brent") {
+        return std::make_unique<min1d::Brent>(eps);
+    } else if (name == "parabole") {
+        return std::make_unique<min1d::Parabole>(eps);
+    } else if (name == "brent-deriv") {
+        return std::make_unique<min1d::BrentDeriv>(eps);
+    } else if (name == "cubic") {
+        return std::make_unique<min1d::Cubic>(eps);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<min_nd::MinSearcher> make_nd_method(std::string_view name, double eps, min1d::MinSearcher & sd_method, const MethodOptions & options)
+{
+    if (name == "gradient") {
+        return std::make_unique<Gradient>(eps, 1000.);
+    } else if (name == "fastest-descent") {
+        return std::make_unique<FastestDescent>(eps, 1000., sd_method);
+    } else if (name == "conjugate-gradient") {
+        return std::make_unique<ConjucateGrad>(eps);
+    } else if (name == "mixed-conjugate-gradient") {
+        return std::make_unique<MixedConjucateGrad>(eps);
+    } else if (name == "pipelined-conjugate-gradient") {
+        return std::make_unique<PipelinedConjucateGrad>(eps);
+    } else if (name == "distributed-conjugate-gradient") {
+        return std::make_unique<DistributedConjucateGrad>(eps, 4);
+    } else if (name == "nelder-mead") {
+        return std::make_unique<NelderMead>(eps, options.parallel, 1., options.pool);
+    } else if (name == "direct") {
+        return std::make_unique<DirectSolver>();
+    }
+    return nullptr;
+}
+
+util::ErrorOr<MethodPair> make_methods(std::string_view nd_name, std::string_view sd_name, double eps, const MethodOptions & options)
+{
+    MethodPair res;
+    res.sd_method = make_sd_method(sd_name, eps);
+    if (!res.sd_method) {
+        return "unknown one dimensional method '" + std::string(sd_name) + "'";
+    }
+    res.nd_method = make_nd_method(nd_name, eps, *res.sd_method, options);
+    if (!res.nd_method) {
+        return "unknown method '" + std::string(nd_name) + "'";
+    }
+    return res;
+}
+
+} // namespace min_nd
@@ -1,19 +1,38 @@
 #include "MinimizatorsAggregator.h"
 
-#include "nd_methods/ConjugateGrad.h"
+#include "MethodRegistry.h"
+
 #include "nd_methods/FastestDescent.h"
-#include "nd_methods/Gradient.h"
-#include "sd_methods/Golden.h"
-#include "sd_methods/Brent.h"
-#include "sd_methods/Dichotomy.h"
 
 #include "util/DiagMatrix.h"
+#include "util/ProblemFile.h"
 #include "util/Vector.h"
 
 #include <optional>
+#include <type_traits>
+#include <variant>
 
 namespace min_nd {
 
+namespace {
+
+const double EPS = 0.000001;
+const double MAX_STEP = 1000.;
+const uint NELDER_MEAD_PARALLEL = 4; // fixed, so that results do not depend on the machine
+
+/*
+ * Fastest descent instantiated for the type of the given one dimensional method.
+ */
+NdMethodVariant make_fastest_descent(const SdMethodVariant & sd_method)
+{
+    return std::visit([](auto & sd_ptr) -> NdMethodVariant {
+        using SdSearcher = typename std::decay_t<decltype(sd_ptr)>::element_type;
+        return std::make_unique<BasicFastestDescent<SdSearcher>>(EPS, MAX_STEP, *sd_ptr);
+    }, sd_method);
+}
+
+} // anonymous namespace
+
 /*static*/ auto MinimizatorsAggregator::select(uint method_id, std::size_t vec_size, std::size_t & to_select) -> MaybeErrorText
 {
     if (method_id < vec_size) {
@@ -26,11 +45,24 @@ namespace min_nd {
 
 auto MinimizatorsAggregator::setup() -> MaybeErrorText
 {
-    m_sd_methods.emplace_back(new min1d::Golden(0.000001));
+    m_sd_methods.emplace_back(std::make_unique<min1d::Golden>(EPS));
+    m_sd_methods.emplace_back(std::make_unique<min1d::Fibonacci>(EPS));
+    m_sd_methods.emplace_back(std::make_unique<min1d::Dichotomy>(EPS / 4, EPS));
+    m_sd_methods.emplace_back(std::make_unique<min1d::Brent>(EPS));
+    m_sd_methods.emplace_back(std::make_unique<min1d::Parabole>(EPS));
+    m_sd_methods.emplace_back(std::make_unique<min1d::BrentDeriv>(EPS));
+    m_sd_methods.emplace_back(std::make_unique<min1d::Cubic>(EPS));
 
-    m_nd_methods.emplace_back(new Gradient(0.000001, 1000.));
-    m_nd_methods.emplace_back(new FastestDescent(0.000001, 1000., curr_sd_searcher()));
-    m_nd_methods.emplace_back(new ConjucateGrad(0.000001));
+    m_nd_methods.emplace_back(std::make_unique<Gradient>(EPS, MAX_STEP));
+    m_nd_methods.emplace_back(make_fastest_descent(m_sd_methods[m_curr_sd_method]));
+    m_nd_methods.emplace_back(std::make_unique<ConjucateGrad>(EPS));
+    m_nd_methods.emplace_back(std::make_unique<MixedConjucateGrad>(EPS));
+    m_nd_methods.emplace_back(std::make_unique<PipelinedConjucateGrad>(EPS));
+    if (!m_eval_pool) {
+        m_eval_pool = std::make_unique<util::ThreadPool>(NELDER_MEAD_PARALLEL - 1);
+    }
+    m_nd_methods.emplace_back(std::make_unique<NelderMead>(EPS, NELDER_MEAD_PARALLEL, 1., m_eval_pool.get()));
+    m_nd_methods.emplace_back(std::make_unique<DirectSolver>());
 
     return std::nullopt;
 }
@@ -44,6 +76,34 @@ auto MinimizatorsAggregator::select_nd_method(uint method_id) -> MaybeErrorText
     return err;
 }
 
+auto MinimizatorsAggregator::select_sd_method(uint method_id) -> MaybeErrorText
+{
+    auto err = select(method_id, m_sd_methods.size(), m_curr_sd_method);
+    if (!err) {
+        rebind_fastest_descent();
+    }
+    return err;
+}
+
+/*
+ * Fastest descent is instantiated for the type of its one dimensional method,
+ * so its instance is replaced, when another one dimensional method is selected.
+ */
+void MinimizatorsAggregator::rebind_fastest_descent()
+{
+    for (auto & method : m_nd_methods) {
+        const bool is_fastest_descent = std::visit([](auto & ptr) {
+            return is_fastest_descent_v<typename std::decay_t<decltype(ptr)>::element_type>;
+        }, method);
+        if (is_fastest_descent) {
+            method = make_fastest_descent(m_sd_methods[m_curr_sd_method]);
+        }
+    }
+    if (m_curr_func < m_funcs.size() && m_curr_nd_method < m_nd_methods.size()) {
+        curr_nd_searcher().set_func(curr_func());
+    }
+}
+
 auto MinimizatorsAggregator::select_function(uint func_id) -> MaybeErrorText
 {
     auto err = select(func_id, m_funcs.size(), m_curr_func);
@@ -55,8 +115,80 @@ auto MinimizatorsAggregator::select_function(uint func_id) -> MaybeErrorText
 
 auto MinimizatorsAggregator::add_function(util::DiagMatrix a, util::Vector b, double c, double eigenvalue) -> MaybeErrorText
 {
-    m_funcs.emplace_back(std::move(a), std::move(b), c, eigenvalue);
+    return add_function(std::make_shared<const util::NFunction>(std::move(a), std::move(b), c, eigenvalue));
+}
+
+auto MinimizatorsAggregator::add_function(util::NFunctionHandle func) -> MaybeErrorText
+{
+    if (!func) {
+        return "function is not set";
+    }
+    m_funcs.push_back(std::move(func));
     return std::nullopt;
 }
 
+auto MinimizatorsAggregator::enable_result_cache(std::size_t memory_budget, const std::string & directory) -> MaybeErrorText
+{
+    auto cache = std::make_unique<ResultCache>(memory_budget);
+    if (!directory.empty()) {
+        if (auto err = cache->open_directory(directory)) {
+            return err;
+        }
+    }
+    m_result_cache = std::move(cache);
+    return std::nullopt;
+}
+
+AsyncSolver & MinimizatorsAggregator::async_solver()
+{
+    if (!m_async_solver) {
+        m_async_solver = std::make_unique<AsyncSolver>();
+    }
+    return *m_async_solver;
+}
+
+SearchRes MinimizatorsAggregator::search_min()
+{
+    return std::visit([this](auto & method) { return search_min(*method); }, m_nd_methods[m_curr_nd_method]);
+}
+
+/*
+ * Search with the method of known type, so that the calls inside of it are dispatched statically.
+ */
+template <class Method>
+SearchRes MinimizatorsAggregator::search_min(Method & searcher)
+{
+    if (!m_result_cache) {
+        return searcher.find_min();
+    }
+
+    const auto key = make_result_key(*curr_func(), searcher);
+    if (auto cached = m_result_cache->find(key)) {
+        return std::move(*cached);
+    }
+
+    auto warm_start = m_result_cache->find_warm_start(key);
+    const bool is_warm = warm_start.has_value();
+    if (is_warm) {
+        searcher.set_start_point(std::move(warm_start));
+    }
+    auto res = searcher.find_min();
+    if (is_warm) {
+        searcher.set_start_point(std::nullopt);
+    }
+    if (res.stop_reason == util::StopReason::Converged) {
+        m_result_cache->insert(key, res); // on failure the cache keeps working in memory only
+    }
+    return res;
+}
+
+auto MinimizatorsAggregator::add_function_from_file(const std::string & path) -> MaybeErrorText
+{
+    auto loaded = util::load_problem(path);
+    if (auto err = std::get_if<std::string>(&loaded)) {
+        return std::move(*err);
+    }
+    return add_function(std::make_shared<const util::NFunction>(std::move(std::get<util::NFunction>(loaded))));
+}
+
 } // namespace min_nd
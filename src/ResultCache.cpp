@@ -0,0 +1,330 @@
+#include "ResultCache.h"
+
+#include "util/Hasher.h"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace min_nd {
+
+namespace {
+
+constexpr std::uint64_t RECORD_MAGIC = 0x3153455250444E;  // "NDPRES1"
+constexpr std::size_t INDEX_READ_CHUNK = 4096;            // index entries read at once
+
+/*
+ * Record of the log, followed by dims coordinates of the found point.
+ */
+struct RecordHeader
+{
+    std::uint64_t magic;
+    std::uint64_t problem;
+    std::uint64_t b;
+    std::uint64_t dims;
+    double min;
+    double residual;
+    std::uint64_t checksum; // of the header with zero checksum and of the point
+    std::uint64_t reserved;
+};
+static_assert(sizeof(RecordHeader) == 64, "result log record layout changed");
+
+struct IndexEntry
+{
+    std::uint64_t problem;
+    std::uint64_t b;
+    std::uint64_t offset; // of the record in the log
+    std::uint64_t check;  // hash of the fields above, to skip garbage
+};
+static_assert(sizeof(IndexEntry) == 32, "result index entry layout changed");
+
+std::uint64_t checksum_of(RecordHeader hdr, const double * point)
+{
+    hdr.checksum = 0;
+    return util::Hasher().add_value(hdr).add(point, hdr.dims * sizeof(double)).digest();
+}
+
+std::uint64_t check_of(const IndexEntry & entry)
+{
+    return util::Hasher().add_value(entry.problem).add_value(entry.b).add_value(entry.offset).digest();
+}
+
+std::string errno_text(const char * what)
+{
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+bool write_all(int fd, const void * data, std::size_t size)
+{
+    const auto * pos = static_cast<const char *>(data);
+    while (size > 0) {
+        const ssize_t written = ::write(fd, pos, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        pos += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool read_all(int fd, void * data, std::size_t size, std::uint64_t offset)
+{
+    auto * pos = static_cast<char *>(data);
+    while (size > 0) {
+        const ssize_t got = ::pread(fd, pos, size, offset);
+        if (got <= 0) {
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        pos += got;
+        size -= got;
+        offset += got;
+    }
+    return true;
+}
+
+std::size_t memory_size(const SearchRes & res)
+{
+    return sizeof(SearchRes) + res.min_point.dims() * sizeof(double) + res.history.capacity() * sizeof(util::IterationStats);
+}
+
+} // anonymous namespace
+
+ResultKey make_result_key(const util::NFunction & func, const MinSearcher & searcher)
+{
+    const std::size_t bytes = func.dims() * sizeof(double);
+
+    util::Hasher problem;
+    problem.add_value(func.dims()).add(func.a().data(), bytes).add_value(func.c()).add_value(func.eigenvalue());
+    searcher.hash_parameters(problem);
+
+    return {problem.digest(), util::Hasher().add(func.b().data(), bytes).digest()};
+}
+
+ResultCache::~ResultCache()
+{
+    close_directory();
+}
+
+util::MaybeErrorText ResultCache::open_directory(const std::string & path)
+{
+    std::lock_guard guard(m_mutex);
+    close_directory();
+
+    if (::mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        return errno_text(("cannot create '" + path + "'").c_str());
+    }
+    const std::string log_path = path + "/results.log";
+    const std::string index_path = path + "/results.idx";
+    m_log_fd = ::open(log_path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_log_fd < 0) {
+        return errno_text(("cannot open '" + log_path + "'").c_str());
+    }
+    m_index_fd = ::open(index_path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_index_fd < 0) {
+        auto err = errno_text(("cannot open '" + index_path + "'").c_str());
+        close_directory();
+        return err;
+    }
+    read_new_index_entries();
+    return std::nullopt;
+}
+
+std::optional<SearchRes> ResultCache::find(const ResultKey & key)
+{
+    std::lock_guard guard(m_mutex);
+    if (auto it = m_memory.find(key); it != m_memory.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        ++m_memory_hits;
+        return it->second->res;
+    }
+    if (auto res = find_on_disk(key)) {
+        insert_to_memory(key, *res);
+        ++m_disk_hits;
+        return res;
+    }
+    ++m_misses;
+    return std::nullopt;
+}
+
+std::optional<util::Vector> ResultCache::find_warm_start(const ResultKey & key)
+{
+    std::lock_guard guard(m_mutex);
+    if (m_log_fd >= 0) {
+        read_new_index_entries();
+    }
+    auto latest = m_latest.find(key.problem);
+    if (latest == m_latest.end() || latest->second.b == key.b) {
+        return std::nullopt;
+    }
+    if (auto it = m_memory.find(latest->second); it != m_memory.end()) {
+        return it->second->res.min_point;
+    }
+    if (auto res = find_on_disk(latest->second)) {
+        return std::move(res->min_point);
+    }
+    return std::nullopt;
+}
+
+util::MaybeErrorText ResultCache::insert(const ResultKey & key, const SearchRes & res)
+{
+    std::lock_guard guard(m_mutex);
+    insert_to_memory(key, res);
+    m_latest[key.problem] = key;
+
+    if (m_log_fd < 0) {
+        return std::nullopt;
+    }
+    auto err = append_to_disk(key, res);
+    if (err) {
+        close_directory();
+    }
+    return err;
+}
+
+void ResultCache::insert_to_memory(const ResultKey & key, const SearchRes & res)
+{
+    if (auto it = m_memory.find(key); it != m_memory.end()) {
+        m_memory_used -= memory_size(it->second->res);
+        it->second->res = res;
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+    } else {
+        m_lru.push_front({key, res});
+        m_memory.emplace(key, m_lru.begin());
+    }
+    m_memory_used += memory_size(res);
+
+    while (m_memory_used > m_memory_budget && !m_lru.empty()) {
+        auto & oldest = m_lru.back();
+        m_memory_used -= memory_size(oldest.res);
+        m_memory.erase(oldest.key);
+        m_lru.pop_back();
+    }
+}
+
+std::optional<SearchRes> ResultCache::find_on_disk(const ResultKey & key)
+{
+    if (m_log_fd < 0) {
+        return std::nullopt;
+    }
+    auto it = m_disk.find(key);
+    if (it == m_disk.end()) {
+        /*
+         * The result could have been added by another process since the index was read last time.
+         */
+        read_new_index_entries();
+        it = m_disk.find(key);
+        if (it == m_disk.end()) {
+            return std::nullopt;
+        }
+    }
+    return read_record(it->second, key);
+}
+
+std::optional<SearchRes> ResultCache::read_record(std::uint64_t offset, const ResultKey & key) const
+{
+    RecordHeader hdr;
+    struct stat st;
+    if (::fstat(m_log_fd, &st) != 0 || !read_all(m_log_fd, &hdr, sizeof(hdr), offset)) {
+        return std::nullopt;
+    }
+    if (hdr.magic != RECORD_MAGIC || hdr.problem != key.problem || hdr.b != key.b
+            || hdr.dims > (static_cast<std::uint64_t>(st.st_size) - offset) / sizeof(double)) {
+        return std::nullopt;
+    }
+    std::vector<double> point(hdr.dims);
+    if (!read_all(m_log_fd, point.data(), hdr.dims * sizeof(double), offset + sizeof(hdr)) || checksum_of(hdr, point.data()) != hdr.checksum) {
+        return std::nullopt;
+    }
+    return SearchRes{util::Vector(std::move(point)), hdr.min, hdr.residual};
+}
+
+util::MaybeErrorText ResultCache::append_to_disk(const ResultKey & key, const SearchRes & res)
+{
+    RecordHeader hdr{RECORD_MAGIC, key.problem, key.b, res.min_point.dims(), res.min, res.residual, 0, 0};
+    hdr.checksum = checksum_of(hdr, res.min_point.data());
+
+    std::vector<char> record(sizeof(hdr) + hdr.dims * sizeof(double));
+    std::memcpy(record.data(), &hdr, sizeof(hdr));
+    std::memcpy(record.data() + sizeof(hdr), res.min_point.data(), hdr.dims * sizeof(double));
+
+    if (::flock(m_log_fd, LOCK_EX) != 0) {
+        return errno_text("cannot lock result log");
+    }
+    util::MaybeErrorText err;
+    const off_t offset = ::lseek(m_log_fd, 0, SEEK_END);
+    struct stat st;
+    if (offset < 0 || !write_all(m_log_fd, record.data(), record.size())) {
+        err = errno_text("cannot write result log");
+    } else if (::fstat(m_index_fd, &st) != 0) {
+        err = errno_text("cannot stat result index");
+    } else {
+        /*
+         * Drop the tail left by an interrupted append, so that entries stay aligned.
+         */
+        if (st.st_size % sizeof(IndexEntry) != 0 && ::ftruncate(m_index_fd, st.st_size - st.st_size % sizeof(IndexEntry)) != 0) {
+            err = errno_text("cannot repair result index");
+        } else {
+            IndexEntry entry{key.problem, key.b, static_cast<std::uint64_t>(offset), 0};
+            entry.check = check_of(entry);
+            if (!write_all(m_index_fd, &entry, sizeof(entry))) {
+                err = errno_text("cannot write result index");
+            } else {
+                m_disk[key] = entry.offset;
+            }
+        }
+    }
+    ::flock(m_log_fd, LOCK_UN);
+    return err;
+}
+
+void ResultCache::read_new_index_entries()
+{
+    struct stat st;
+    if (::fstat(m_index_fd, &st) != 0) {
+        return;
+    }
+    const std::uint64_t size = st.st_size - st.st_size % sizeof(IndexEntry);
+
+    std::vector<IndexEntry> entries;
+    while (m_index_read < size) {
+        entries.resize(std::min<std::uint64_t>(INDEX_READ_CHUNK, (size - m_index_read) / sizeof(IndexEntry)));
+        if (!read_all(m_index_fd, entries.data(), entries.size() * sizeof(IndexEntry), m_index_read)) {
+            return;
+        }
+        for (const auto & entry : entries) {
+            if (entry.check == check_of(entry)) {
+                const ResultKey key{entry.problem, entry.b};
+                m_disk[key] = entry.offset;
+                m_latest[key.problem] = key;
+            }
+        }
+        m_index_read += entries.size() * sizeof(IndexEntry);
+    }
+}
+
+void ResultCache::close_directory() noexcept
+{
+    if (m_log_fd >= 0) {
+        ::close(m_log_fd);
+    }
+    if (m_index_fd >= 0) {
+        ::close(m_index_fd);
+    }
+    m_log_fd = m_index_fd = -1;
+    m_index_read = 0;
+    m_disk.clear();
+}
+
+} // namespace min_nd
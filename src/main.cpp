@@ -1,12 +1,23 @@
+#include "BatchRunner.h"
 #include "MinimizatorsAggregator.h"
 
+#include "util/BufferedWriter.h"
 #include "util/DiagMatrix.h"
 #include "util/Misc.h"
+#include "util/ProblemGenerator.h"
+#include "util/ThreadPool.h"
+#include "util/Tracing.h"
 #include "util/Vector.h"
 #include "util/VersionedData.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <optional>
+#include <thread>
+
+#include <unistd.h>
 
 template <class... Args>
 void println(Args &&... args)
@@ -14,8 +25,133 @@ void println(Args &&... args)
     ((std::cout << args << ' '), ...) << '\n';
 }
 
-int main()
+/*
+ * Batch mode: 1d-minimize --batch [--threads N] [--window N] [--unordered] [--eval-threads N] [--trace FILE]
+ * Reads jobs from stdin and writes results to stdout, one JSON object per line (see BatchRunner.h).
+ * With --eval-threads, jobs share a pool of N threads to evaluate candidates of nelder-mead concurrently.
+ * With --trace, timeline of the whole batch is written to FILE in Chrome trace format (see util/Tracing.h).
+ */
+int run_batch(int argc, char ** argv)
 {
+    min_nd::BatchOptions options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    options.window = 4 * options.threads;
+    const char * trace_path = nullptr;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            options.threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--window") == 0 && has_value) {
+            options.window = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--unordered") == 0) {
+            options.ordered = false;
+        } else if (std::strcmp(argv[i], "--eval-threads") == 0 && has_value) {
+            options.eval_threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && has_value) {
+            trace_path = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " --batch [--threads N] [--window N] [--unordered] [--eval-threads N] [--trace FILE]\n";
+            return 2;
+        }
+    }
+
+    if (trace_path) {
+        util::set_trace_thread_name("main");
+        util::enable_tracing(true);
+    }
+
+    std::ios::sync_with_stdio(false);
+    util::BufferedWriter out(STDOUT_FILENO);
+    if (auto err = min_nd::BatchRunner(options).run(std::cin, out)) {
+        std::cerr << *err << '\n';
+        return 1;
+    }
+    if (trace_path) {
+        util::enable_tracing(false);
+        if (auto err = util::save_chrome_trace(trace_path)) {
+            std::cerr << *err << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Generator mode: 1d-minimize --generate PATH DIMS [--seed N] [--spectrum uniform|geometric|clustered]
+ *                 [--min X] [--max X] [--cond X] [--clusters N] [--threads N]
+ * Writes synthetic problem into problem file (see util/ProblemFile.h), the same seed gives the same problem.
+ */
+int run_generate(int argc, char ** argv)
+{
+    auto usage = [argv] {
+        std::cerr << "usage: " << argv[0] << " --generate PATH DIMS [--seed N] [--spectrum uniform|geometric|clustered]"
+                  << " [--min X] [--max X] [--cond X] [--clusters N] [--threads N]\n";
+        return 2;
+    };
+    if (argc < 4) {
+        return usage();
+    }
+
+    util::ProblemSpec spec;
+    spec.dims = std::strtoull(argv[3], nullptr, 10);
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::optional<double> cond;
+    for (int i = 4; i < argc; i++)
+    {
+        if (i + 1 >= argc) {
+            return usage();
+        }
+        const char * value = argv[i + 1];
+        if (std::strcmp(argv[i], "--seed") == 0) {
+            spec.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--spectrum") == 0) {
+            if (std::strcmp(value, "uniform") == 0) {
+                spec.spectrum = util::Spectrum::Uniform;
+            } else if (std::strcmp(value, "geometric") == 0) {
+                spec.spectrum = util::Spectrum::Geometric;
+            } else if (std::strcmp(value, "clustered") == 0) {
+                spec.spectrum = util::Spectrum::Clustered;
+            } else {
+                return usage();
+            }
+        } else if (std::strcmp(argv[i], "--min") == 0) {
+            spec.min_eigenvalue = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--max") == 0) {
+            spec.max_eigenvalue = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--cond") == 0) {
+            cond = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--clusters") == 0) {
+            spec.clusters = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            threads = std::strtoull(value, nullptr, 10);
+        } else {
+            return usage();
+        }
+        i++;
+    }
+    if (cond) {
+        spec.with_condition_number(*cond);
+    }
+
+    util::ThreadPool pool(threads > 1 ? threads - 1 : 0); // the calling thread works too
+    if (auto err = util::generate_problem_file(argv[2], spec, &pool)) {
+        std::cerr << *err << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) {
+        return run_batch(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--generate") == 0) {
+        return run_generate(argc, argv);
+    }
+
     std::cout << std::setprecision(std::numeric_limits<double>::digits10 + 1);
     min_nd::MinimizatorsAggregator agg;
     agg.setup();
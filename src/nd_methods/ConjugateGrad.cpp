@@ -5,6 +5,7 @@
 #include "util/Vector.h"
 #include "util/VersionedData.h"
 
+#include <cmath>
 #include <iostream>
 
 namespace min_nd {
@@ -25,16 +26,17 @@ SearchRes ConjucateGrad::find_min_impl()
     /*
      * Initialize starting values.
      */
-    util::Vector curr(func.dims());
+    util::Vector curr = start_point();
     auto grad = func.grad(curr);
     auto p = grad * -1.;
 
     double grad_len_pow2 = grad.length_pow2();
+    double f = func(curr); // tracked incrementally for the convergence history
     util::Vector a_by_p(func.dims());
     double beta = 0.;
     uint iter_num = 0; // to track number of iterations and to prevent infinite or very long cycles.
 
-    while (grad_len_pow2 >= eps_pow2 && iter_num < MAX_ITER) {
+    while (grad_len_pow2 >= eps_pow2 && !budget_exhausted(iter_num)) {
         /*
          * "Restart" the method to avoid 
          * accumulating computing error
@@ -43,8 +45,11 @@ SearchRes ConjucateGrad::find_min_impl()
             beta = 0.;
         }
 
+        enter_phase(util::Phase::MatVec);
         a_by_p = func.a() * p; // compute A * p_k
+        enter_phase(util::Phase::VectorOps);
         double alpha = grad_len_pow2 / (a_by_p * p); // compute coefficient alpha
+        f -= alpha * grad_len_pow2 / 2; // exact decrease of the quadratic function along p
 
         curr = curr + alpha * p; // update position
         grad = grad + alpha * a_by_p; // update gradient
@@ -52,10 +57,11 @@ SearchRes ConjucateGrad::find_min_impl()
         p = beta * p - grad; //update the conjugate vector
 
         grad_len_pow2 = grad.length_pow2();
+        record_iteration(iter_num, grad_len_pow2, f, alpha, beta, 1);
         iter_num++;
     }
 
-    return {curr, func(curr)};
+    return {curr, func(curr), std::sqrt(grad_len_pow2)};
 }
 
 /*
@@ -66,49 +72,58 @@ TracedSearchRes ConjucateGrad::find_min_traced_impl()
     const double eps_pow2 = m_eps * m_eps;
     auto & func = curr_func();
 
-    util::Vector curr(func.dims());
+    util::Vector curr = start_point();
     auto grad = func.grad(curr);
     auto p = grad * -1.;
 
     double grad_len_pow2 = grad.length_pow2();
+    double f = func(curr); // tracked incrementally for the convergence history
     util::Vector a_by_p(func.dims());
     double beta = 0.;
     uint iter_num = 0;
 
-    while (grad_len_pow2 >= eps_pow2 && iter_num < MAX_ITER) {
+    while (grad_len_pow2 >= eps_pow2 && !budget_exhausted(iter_num)) {
         if (iter_num % func.dims() == 0) {
             beta = 0.;
         }
 
+        enter_phase(util::Phase::Trace);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "x, f, grad, p");
         m_replay_data.emplace_back<util::VdVector>(iter_num, curr);
         m_replay_data.emplace_back<util::VdDouble>(iter_num, func(curr));
         m_replay_data.emplace_back<util::VdVector>(iter_num, grad);
         m_replay_data.emplace_back<util::VdVector>(iter_num, p);
 
+        enter_phase(util::Phase::MatVec);
         a_by_p = func.a() * p;
+        enter_phase(util::Phase::VectorOps);
         double alpha = grad_len_pow2 / (a_by_p * p);
+        f -= alpha * grad_len_pow2 / 2;
+        enter_phase(util::Phase::Trace);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "alpha, beta");
         m_replay_data.emplace_back<util::VdDouble>(iter_num, alpha);
         m_replay_data.emplace_back<util::VdDouble>(iter_num, beta);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "x shift");
         m_replay_data.emplace_back<util::VdVector>(iter_num, alpha * p);
 
+        enter_phase(util::Phase::VectorOps);
         curr = curr + alpha * p;
         grad = grad + alpha * a_by_p;
         beta = grad.length_pow2() / grad_len_pow2;
         p = beta * p - grad;
 
         grad_len_pow2 = grad.length_pow2();
+        record_iteration(iter_num, grad_len_pow2, f, alpha, beta, 1);
         iter_num++;
     }
 
+    enter_phase(util::Phase::Trace);
     m_replay_data.emplace_back<util::VdComment>(iter_num, "x, grad, p");
     m_replay_data.emplace_back<util::VdVector>(iter_num, curr);
     m_replay_data.emplace_back<util::VdVector>(iter_num, grad);
     m_replay_data.emplace_back<util::VdVector>(iter_num, p);
 
-    return {curr, func(curr), m_replay_data};
+    return {{curr, func(curr), std::sqrt(grad_len_pow2)}, m_replay_data};
 }
 
 } // namespace min_nd
@@ -0,0 +1,104 @@
+#include "nd_methods/DirectSolver.h"
+
+#include "util/ReplayData.h"
+#include "util/Vector.h"
+#include "util/VersionedData.h"
+
+#include <cmath>
+
+namespace min_nd {
+
+/*
+ * A is immutable and shared by copies of the function, so it is the same matrix,
+ * if and only if its diagonal is the same array.
+ */
+const util::ErrorOr<util::SparseCholesky> & DirectSolver::factorization()
+{
+    const auto & diag = curr_func().a().diag();
+    if (!m_factorization || m_factored.data() != diag.data() || m_factored.size() != diag.size()) {
+        m_factorization = util::SparseCholesky::factorize(curr_func().a());
+        m_factored = diag;
+    }
+    return *m_factorization;
+}
+
+std::optional<util::Vector> DirectSolver::solve()
+{
+    enter_phase(util::Phase::Other);
+    const auto & factorized = factorization();
+    if (std::holds_alternative<std::string>(factorized)) {
+        return std::nullopt;
+    }
+    enter_phase(util::Phase::VectorOps);
+    const auto & b = curr_func().b();
+    std::vector<double> minus_b(b.size());
+    for (std::size_t i = 0; i < b.size(); ++i) {
+        minus_b[i] = -b[i];
+    }
+    return std::get<util::SparseCholesky>(factorized).solve(util::Vector(std::move(minus_b)));
+}
+
+/*
+ * Idea: gradient of f is A x + b, so the minimum is the only point, where it is zero.
+ * The system is solved in one iteration, its residual is only rounding error.
+ */
+SearchRes DirectSolver::find_min_impl()
+{
+    auto & func = curr_func();
+    util::Vector curr = start_point();
+    if (budget_exhausted(0)) {
+        return {curr, func(curr), std::sqrt(func.grad(curr).length_pow2())};
+    }
+
+    auto found = solve();
+    if (!found) {
+        m_stop_reason = util::StopReason::Failed;
+        return {curr, func(curr), std::sqrt(func.grad(curr).length_pow2())};
+    }
+    curr = std::move(*found);
+    enter_phase(util::Phase::MatVec);
+    const double f = func(curr);
+    const double grad_len_pow2 = func.grad(curr).length_pow2();
+    record_iteration(0, grad_len_pow2, f, 0., 0., 1);
+
+    return {curr, f, std::sqrt(grad_len_pow2)};
+}
+
+/*
+ * Version with tracing output.
+ */
+TracedSearchRes DirectSolver::find_min_traced_impl()
+{
+    auto & func = curr_func();
+    util::Vector curr = start_point();
+    enter_phase(util::Phase::Trace);
+    m_replay_data.emplace_back<util::VdComment>(0, "start x");
+    m_replay_data.emplace_back<util::VdVector>(0, curr);
+    if (budget_exhausted(0)) {
+        return {{curr, func(curr), std::sqrt(func.grad(curr).length_pow2())}, m_replay_data};
+    }
+
+    auto found = solve();
+    if (!found) {
+        m_stop_reason = util::StopReason::Failed;
+        enter_phase(util::Phase::Trace);
+        m_replay_data.emplace_back<util::VdComment>(1, "A is not positive definite");
+        return {{curr, func(curr), std::sqrt(func.grad(curr).length_pow2())}, m_replay_data};
+    }
+    curr = std::move(*found);
+    enter_phase(util::Phase::MatVec);
+    const double f = func(curr);
+    auto grad = func.grad(curr);
+    const double grad_len_pow2 = grad.length_pow2();
+    record_iteration(0, grad_len_pow2, f, 0., 0., 1);
+
+    enter_phase(util::Phase::Trace);
+    m_replay_data.emplace_back<util::VdComment>(1, "x, f, grad");
+    m_replay_data.emplace_back<util::VdVector>(1, curr);
+    m_replay_data.emplace_back<util::VdDouble>(1, f);
+    m_replay_data.emplace_back<util::VdVector>(1, grad);
+
+    return {{curr, f, std::sqrt(grad_len_pow2)}, m_replay_data};
+}
+
+} // namespace min_nd
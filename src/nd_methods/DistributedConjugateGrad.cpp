@@ -0,0 +1,221 @@
+#include "nd_methods/DistributedConjugateGrad.h"
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/ProcessGroup.h"
+#include "util/SharedMemory.h"
+#include "util/Vector.h"
+#include "util/VersionedData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <new>
+#include <vector>
+
+namespace min_nd {
+
+namespace {
+
+struct Slice
+{
+    std::size_t from, to;
+};
+
+/*
+ * Split dims coordinates between processes as evenly as possible.
+ */
+Slice slice_of(std::size_t dims, std::size_t processes, std::size_t rank)
+{
+    const std::size_t base = dims / processes;
+    const std::size_t extra = dims % processes;
+    const std::size_t from = rank * base + std::min(rank, extra);
+    return {from, from + base + (rank < extra ? 1 : 0)};
+}
+
+/*
+ * Conjugate gradient iterations of one process on its slice.
+ * A and b of the slice are copied into memory of the process, so they are placed near the core that uses them.
+ * As the matrix is diagonal, A * p needs only the own slice of p and there are no halo exchanges;
+ * only the two dot products of each iteration are reduced between processes.
+ * Search starts from the point in result, the answer is written there too.
+ * Returns false, if the group was aborted: some process failed, and the answer is not written.
+ * Only the calling process decides to stop by should_stop(iter_num) and tells the others through the shared stop flag.
+ * on_iteration(iter_num, alpha, beta, prev_len_pow2, grad_len_pow2) is called after each iteration
+ * with squared gradient lengths before and after it.
+ */
+template <class ShouldStop, class OnIteration>
+bool solve_slice(const util::NFunction & func, Slice sl, std::size_t rank, util::ShmCommunicator & comm, double eps_pow2, std::atomic<bool> & stop, double * result, ShouldStop && should_stop, OnIteration && on_iteration)
+{
+    const std::size_t n = sl.to - sl.from;
+    const std::vector<double> diag(func.a().data() + sl.from, func.a().data() + sl.to);
+
+    std::vector<double> x(result + sl.from, result + sl.to);
+    std::vector<double> grad(n), p(n), a_by_p(n);
+
+    double local = 0.;
+    for (std::size_t j = 0; j < n; ++j) {
+        grad[j] = diag[j] * x[j] + func.b()[sl.from + j];
+        p[j] = -grad[j];
+        local += grad[j] * grad[j];
+    }
+    double grad_len_pow2 = local;
+    if (!comm.allreduce_sum(rank, grad_len_pow2)) {
+        return false;
+    }
+
+    uint iter_num = 0;
+    while (grad_len_pow2 >= eps_pow2) {
+        if (rank == 0 && should_stop(iter_num)) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+
+        local = 0.;
+        for (std::size_t j = 0; j < n; ++j) {
+            a_by_p[j] = diag[j] * p[j];
+            local += a_by_p[j] * p[j];
+        }
+        if (!comm.allreduce_sum(rank, local)) {
+            return false;
+        }
+        const double alpha = grad_len_pow2 / local;
+        /*
+         * The flag is set before the reduction and read after it, so all processes see the same value.
+         */
+        if (stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        local = 0.;
+        for (std::size_t j = 0; j < n; ++j) {
+            x[j] += alpha * p[j];
+            grad[j] += alpha * a_by_p[j];
+            local += grad[j] * grad[j];
+        }
+        if (!comm.allreduce_sum(rank, local)) {
+            return false;
+        }
+        const double new_len_pow2 = local;
+        const double beta = new_len_pow2 / grad_len_pow2;
+        for (std::size_t j = 0; j < n; ++j) {
+            p[j] = beta * p[j] - grad[j];
+        }
+
+        on_iteration(iter_num, alpha, beta, grad_len_pow2, new_len_pow2);
+        grad_len_pow2 = new_len_pow2;
+        iter_num++;
+    }
+
+    std::copy(x.begin(), x.end(), result + sl.from);
+    return true;
+}
+
+} // anonymous namespace
+
+/*
+ * Idea: the same as in conjugate gradient method, but coordinates are split into slices between processes.
+ * Processes are forked from the calling one and run the same iterations on their slices;
+ * every reduction gives all of them the same alpha and beta, so they stop at the same iteration.
+ * Slices of the answer are gathered in shared memory.
+ * If processes cannot be started (e.g. the caller has several threads) or some of them fails,
+ * the method falls back to the in-process conjugate gradient.
+ */
+SearchRes DistributedConjucateGrad::find_min_impl()
+{
+    const double eps_pow2 = m_eps * m_eps;
+    auto & func = curr_func();
+    const std::size_t processes = std::clamp<std::size_t>(m_processes, 1, func.dims());
+
+    util::ShmCommunicator comm(processes);
+    util::ShmRegion result(func.dims() * sizeof(double));
+    util::ShmRegion stop_flag(sizeof(std::atomic<bool>));
+    if (!comm.valid() || !result.valid() || !stop_flag.valid()) {
+        return ConjucateGrad::find_min_impl();
+    }
+
+    auto * res_data = static_cast<double *>(result.data());
+    auto * stop = new (stop_flag.data()) std::atomic<bool>(false);
+    auto should_stop = [this](uint iter_num) { return budget_exhausted(iter_num); };
+    const auto start = start_point();
+    std::copy(start.data(), start.data() + start.dims(), res_data);
+    double f = func(start); // tracked incrementally for the convergence history
+    util::ProcessGroup group(processes);
+    comm.set_watchdog([&group] { return group.peers_alive(); });
+    auto err = group.run([&](std::size_t rank) {
+        auto on_iteration = [&](uint iter_num, double alpha, double beta, double prev_len_pow2, double grad_len_pow2) {
+            if (rank == 0) {
+                f -= alpha * prev_len_pow2 / 2;
+                record_iteration(iter_num, grad_len_pow2, f, alpha, beta, 1);
+            }
+        };
+        solve_slice(func, slice_of(func.dims(), processes, rank), rank, comm, eps_pow2, *stop, res_data, should_stop, on_iteration);
+    });
+    if (err || comm.aborted()) {
+        restart_search();
+        return ConjucateGrad::find_min_impl();
+    }
+
+    util::Vector curr(std::vector<double>(res_data, res_data + func.dims()));
+    return {curr, func(curr), std::sqrt(func.grad(curr).length_pow2())};
+}
+
+/*
+ * Version with tracing output.
+ * Only the calling process (rank 0) records tracing information.
+ */
+TracedSearchRes DistributedConjucateGrad::find_min_traced_impl()
+{
+    const double eps_pow2 = m_eps * m_eps;
+    auto & func = curr_func();
+    const std::size_t processes = std::clamp<std::size_t>(m_processes, 1, func.dims());
+
+    util::ShmCommunicator comm(processes);
+    util::ShmRegion result(func.dims() * sizeof(double));
+    util::ShmRegion stop_flag(sizeof(std::atomic<bool>));
+    if (!comm.valid() || !result.valid() || !stop_flag.valid()) {
+        m_replay_data.emplace_back<util::VdComment>(0, "shared memory is not available, solve in one process");
+        return ConjucateGrad::find_min_traced_impl();
+    }
+
+    m_replay_data.emplace_back<util::VdComment>(0, "number of processes");
+    m_replay_data.emplace_back<util::VdDouble>(0, processes);
+
+    auto * res_data = static_cast<double *>(result.data());
+    auto * stop = new (stop_flag.data()) std::atomic<bool>(false);
+    auto should_stop = [this](uint iter_num) { return budget_exhausted(iter_num); };
+    const auto start = start_point();
+    std::copy(start.data(), start.data() + start.dims(), res_data);
+    double f = func(start);
+    uint iter_cnt = 0;
+    util::ProcessGroup group(processes);
+    comm.set_watchdog([&group] { return group.peers_alive(); });
+    auto err = group.run([&](std::size_t rank) {
+        auto on_iteration = [&](uint iter_num, double alpha, double beta, double prev_len_pow2, double grad_len_pow2) {
+            if (rank == 0) {
+                f -= alpha * prev_len_pow2 / 2;
+                record_iteration(iter_num, grad_len_pow2, f, alpha, beta, 1);
+                m_replay_data.emplace_back<util::VdComment>(iter_num, "alpha, beta, grad length");
+                m_replay_data.emplace_back<util::VdDouble>(iter_num, alpha);
+                m_replay_data.emplace_back<util::VdDouble>(iter_num, beta);
+                m_replay_data.emplace_back<util::VdDouble>(iter_num, std::sqrt(grad_len_pow2));
+                iter_cnt = iter_num + 1;
+            }
+        };
+        solve_slice(func, slice_of(func.dims(), processes, rank), rank, comm, eps_pow2, *stop, res_data, should_stop, on_iteration);
+    });
+    if (err || comm.aborted()) {
+        restart_search();
+        m_replay_data.emplace_back<util::VdComment>(0, (err ? *err : std::string("worker process failed")) + ", solve in one process");
+        return ConjucateGrad::find_min_traced_impl();
+    }
+
+    util::Vector curr(std::vector<double>(res_data, res_data + func.dims()));
+    const double residual = std::sqrt(func.grad(curr).length_pow2());
+    m_replay_data.emplace_back<util::VdComment>(iter_cnt, "x, residual length");
+    m_replay_data.emplace_back<util::VdVector>(iter_cnt, curr);
+    m_replay_data.emplace_back<util::VdDouble>(iter_cnt, residual);
+
+    return {{curr, func(curr), residual}, m_replay_data};
+}
+
+} // namespace min_nd
@@ -1,12 +1,22 @@
 #include "nd_methods/FastestDescent.h"
 
 #include "nd_methods/MinSearcher.h"
+#include "sd_methods/Brent.h"
+#include "sd_methods/BrentDeriv.h"
+#include "sd_methods/Cubic.h"
+#include "sd_methods/Dichotomy.h"
+#include "sd_methods/Fibonacci.h"
+#include "sd_methods/Golden.h"
+#include "sd_methods/KSection.h"
 #include "sd_methods/MinSearcher.h"
+#include "sd_methods/Parabole.h"
 
 #include "util/Function.h"
 #include "util/Vector.h"
 #include "util/VersionedData.h"
 
+#include <cmath>
+
 namespace min_nd {
 /*
  * Idea: after finding gradient of the function do not make a small step in the direction of the antigradient.
@@ -14,65 +24,175 @@ namespace min_nd {
  * After finding minimum on the chosen direction, find function's gradient again. 
  * Repeat the algorithm.
  */
-SearchRes FastestDescent::find_min_impl()
+template <class SdSearcher>
+SearchRes BasicFastestDescent<SdSearcher>::find_min_impl()
 {
     const double eps_pow2 = m_eps * m_eps;
     auto & func = curr_func();
     m_alpha = 1 / func.eigenvalue();
 
-    util::Vector curr(func.dims()); // Vector of current coordinates
+    util::Vector curr = start_point(); // Vector of current coordinates
     double f_curr = func(curr);
 
     util::Vector grad = func.grad(curr);
     min1d::SearchRes sd_min;    // Minimum found on the chosen direction
     uint iter_num = 0;      // To prevent infinite or very long cycles
-    while (grad.length_pow2() >= eps_pow2 && iter_num < MAX_ITER) {
-        sd_min = find_sd_min({[&](double x) { return func(curr - x * grad); }, {0., m_alpha}});
+    double grad_len_pow2 = grad.length_pow2();
+    while (grad_len_pow2 >= eps_pow2 && !budget_exhausted(iter_num)) {
+        enter_phase(util::Phase::LineSearch);
+        sd_min = find_sd_min({[&](double x) { return func(curr - x * grad); },
+                              [&](double x) { return -(func.grad(curr - x * grad) * grad); }, // derivative along the direction
+                              {0., m_alpha}});
+        enter_phase(util::Phase::VectorOps);
         curr = curr - sd_min.min_point * grad;
+        f_curr = sd_min.min;
+        enter_phase(util::Phase::MatVec);
         grad = func.grad(curr);
+        enter_phase(util::Phase::VectorOps);
+        grad_len_pow2 = grad.length_pow2();
+        record_iteration(iter_num, grad_len_pow2, f_curr, sd_min.min_point, 0., sd_evals());
         iter_num++;
     }
 
-    return {curr, sd_min.min};
+    return {curr, f_curr, std::sqrt(grad_len_pow2)};
 }
 
 /*
  * Version with tracing output.
  */
-TracedSearchRes FastestDescent::find_min_traced_impl()
+template <class SdSearcher>
+TracedSearchRes BasicFastestDescent<SdSearcher>::find_min_traced_impl()
 {
     const double eps_pow2 = m_eps * m_eps;
     auto & func = curr_func();
     m_alpha = 1 / func.eigenvalue();
 
-    util::Vector curr(func.dims());
+    util::Vector curr = start_point();
     double f_curr = func(curr);
 
     util::Vector grad = func.grad(curr);
     min1d::SearchRes sd_min;
 
     uint iter_num = 0;
-    while (grad.length_pow2() >= eps_pow2 && iter_num < MAX_ITER) {
+    double grad_len_pow2 = grad.length_pow2();
+    while (grad_len_pow2 >= eps_pow2 && !budget_exhausted(iter_num)) {
+        enter_phase(util::Phase::Trace);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "x, f, grad");
         m_replay_data.emplace_back<util::VdVector>(iter_num, curr);
         m_replay_data.emplace_back<util::VdDouble>(iter_num, func(curr));
         m_replay_data.emplace_back<util::VdVector>(iter_num, grad);
 
-        sd_min = find_sd_min({[&](double x) { return func(curr - x * grad); }, {0., m_alpha}});
+        enter_phase(util::Phase::LineSearch);
+        sd_min = find_sd_min({[&](double x) { return func(curr - x * grad); },
+                              [&](double x) { return -(func.grad(curr - x * grad) * grad); },
+                              {0., m_alpha}});
 
+        enter_phase(util::Phase::Trace);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "found min, iterations needed");
         m_replay_data.emplace_back<util::VdPoint>(iter_num, sd_min.min_point, sd_min.min);
         m_replay_data.emplace_back<util::VdDouble>(iter_num, static_cast<double>(last_sd_func().call_count()));
 
+        enter_phase(util::Phase::VectorOps);
         curr = curr - sd_min.min_point * grad;
+        f_curr = sd_min.min;
+        enter_phase(util::Phase::MatVec);
         grad = func.grad(curr);
+        enter_phase(util::Phase::VectorOps);
+        grad_len_pow2 = grad.length_pow2();
+        record_iteration(iter_num, grad_len_pow2, f_curr, sd_min.min_point, 0., sd_evals());
 
         ++iter_num;
     }
+    enter_phase(util::Phase::Trace);
     m_replay_data.emplace_back<util::VdComment>(iter_num, "x, grad");
     m_replay_data.emplace_back<util::VdVector>(iter_num, curr);
     m_replay_data.emplace_back<util::VdVector>(iter_num, grad);
-    return {curr, sd_min.min, m_replay_data};
+    return {{curr, f_curr, std::sqrt(grad_len_pow2)}, m_replay_data};
+}
+
+template struct BasicFastestDescent<min1d::MinSearcher>;
+template struct BasicFastestDescent<min1d::Golden>;
+template struct BasicFastestDescent<min1d::Fibonacci>;
+template struct BasicFastestDescent<min1d::Dichotomy>;
+template struct BasicFastestDescent<min1d::KSection>;
+template struct BasicFastestDescent<min1d::Brent>;
+template struct BasicFastestDescent<min1d::Parabole>;
+template struct BasicFastestDescent<min1d::BrentDeriv>;
+template struct BasicFastestDescent<min1d::Cubic>;
+
+template <class LineStepper>
+FastestDescentStepper<LineStepper>::FastestDescentStepper(util::Vector start, double eps, double max_step, double sd_eps,
+                                                          util::SolveBudget budget, util::SolveBudget sd_budget)
+    : Stepper(start.dims(), std::move(budget))
+    , m_eps(eps)
+    , m_max_step(max_step)
+    , m_sd_eps(sd_eps)
+    , m_sd_budget(std::move(sd_budget))
+    , m_curr(start.dims())
+    , m_grad(start.dims())
+{
+    request(std::move(start), true);
+}
+
+/*
+ * The same steps as in BasicFastestDescent::find_min_impl, but values and gradients are requested instead of calculated.
+ */
+template <class LineStepper>
+void FastestDescentStepper<LineStepper>::tell(const EvalReply & reply)
+{
+    check_reply(reply);
+    switch (m_state) {
+    case State::Start:
+        m_curr = std::move(m_request.points[0]);
+        m_f_curr = reply.values[0];
+        m_grad = reply.gradients[0];
+        m_grad_len_pow2 = m_grad.length_pow2();
+        next();
+        break;
+    case State::LineSearch:
+        m_line->tell(reply.values);
+        if (!m_line->done()) {
+            request_line_points();
+            break;
+        }
+        m_sd_min = m_line->result();
+        m_curr = m_curr - m_sd_min.min_point * m_grad;
+        m_f_curr = m_sd_min.min;
+        request(m_curr, true);
+        m_state = State::Gradient;
+        break;
+    case State::Gradient:
+        m_grad = reply.gradients[0];
+        m_grad_len_pow2 = m_grad.length_pow2();
+        record_iteration(m_grad_len_pow2, m_f_curr, m_sd_min.min_point, 0., static_cast<uint>(m_line->evaluations()));
+        next();
+        break;
+    }
+}
+
+template <class LineStepper>
+void FastestDescentStepper<LineStepper>::next()
+{
+    if (m_grad_len_pow2 >= m_eps * m_eps && !budget_exhausted()) {
+        m_line.emplace(util::Function::Bounds{0., m_max_step}, m_sd_eps, m_sd_budget);
+        request_line_points();
+        m_state = State::LineSearch;
+    } else {
+        finish(m_curr, m_f_curr, m_grad_len_pow2);
+    }
 }
 
+template <class LineStepper>
+void FastestDescentStepper<LineStepper>::request_line_points()
+{
+    m_request.points.clear();
+    for (const double x : m_line->ask()) {
+        m_request.points.push_back(m_curr - x * m_grad);
+    }
+    m_request.with_gradient = false;
+}
+
+template struct FastestDescentStepper<min1d::GoldenStepper>;
+template struct FastestDescentStepper<min1d::BrentStepper>;
+
 } // namespace min_nd
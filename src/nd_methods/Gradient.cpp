@@ -6,6 +6,7 @@
 #include "util/Vector.h"
 #include "util/VersionedData.h"
 
+#include <cmath>
 #include <iostream>
 
 namespace min_nd {
@@ -27,7 +28,7 @@ SearchRes Gradient::find_min_impl()
     m_alpha = 1 / func.eigenvalue();
     double alpha = m_alpha;
 
-    util::Vector curr_vec(func.dims());
+    util::Vector curr_vec = start_point();
     double f_curr = func(curr_vec);
 
     util::Vector next_vec(func.dims());
@@ -37,29 +38,39 @@ SearchRes Gradient::find_min_impl()
 
     // recalc function
     auto count_next = [&] {
+        enter_phase(util::Phase::VectorOps);
         next_vec = curr_vec - alpha * grad;
+        enter_phase(util::Phase::MatVec);
         f_next = func(next_vec);
     };
 
     uint iter_num = 0;  // To prevent infinite or very long cycles
-    for (auto length = grad.length_pow2(); length >= eps_pow2 && iter_num < MAX_ITER; length = grad.length_pow2()) {
+    double length = grad.length_pow2();
+    while (length >= eps_pow2 && !budget_exhausted(iter_num)) {
+        uint evals = 1;
         for (count_next(); f_next >= f_curr && alpha > m_eps; count_next()) {
             /*
              * New value is bigger than current. Reduce the step size and try again;
              */
             alpha /= 2;
+            evals++;
         }
         /*
          * New value is less than current. Move to it and continue iterating.
          */
+        const double step = alpha;
         alpha = m_alpha;
         curr_vec = std::move(next_vec);
         f_curr = f_next;
+        enter_phase(util::Phase::MatVec);
         grad = func.grad(curr_vec);
+        enter_phase(util::Phase::VectorOps);
+        length = grad.length_pow2();
+        record_iteration(iter_num, length, f_curr, step, 0., evals);
         iter_num++;
     }
 
-    return {curr_vec, f_curr};
+    return {curr_vec, f_curr, std::sqrt(grad.length_pow2())};
 }
 
 /*
@@ -75,7 +86,7 @@ TracedSearchRes Gradient::find_min_traced_impl()
     m_replay_data.emplace_back<util::VdComment>(0, "func dims");
     m_replay_data.emplace_back<util::VdDouble>(0, func.dims());
 
-    util::Vector curr_vec(func.dims());
+    util::Vector curr_vec = start_point();
     double f_curr = func(curr_vec);
 
     util::Vector next_vec(func.dims());
@@ -84,38 +95,115 @@ TracedSearchRes Gradient::find_min_traced_impl()
     auto grad = func.grad(curr_vec);
 
     auto count_next = [&] {
+        enter_phase(util::Phase::VectorOps);
         next_vec = curr_vec - alpha * grad;
+        enter_phase(util::Phase::MatVec);
         f_next = func(next_vec);
     };
 
     uint iter_num = 0;
-    for (auto length = grad.length_pow2(); length >= eps_pow2 && iter_num < MAX_ITER; length = grad.length_pow2()) {
+    double length = grad.length_pow2();
+    while (length >= eps_pow2 && !budget_exhausted(iter_num)) {
+        enter_phase(util::Phase::Trace);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "x and f(x)");
         m_replay_data.emplace_back<util::VdVector>(iter_num, curr_vec);
         m_replay_data.emplace_back<util::VdDouble>(iter_num, f_curr);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "grad");
         m_replay_data.emplace_back<util::VdVector>(iter_num, grad);
 
+        uint evals = 1;
         for (count_next(); f_next >= f_curr && alpha > m_eps; count_next()) {
             alpha /= 2;
+            evals++;
         }
+        enter_phase(util::Phase::Trace);
         m_replay_data.emplace_back<util::VdComment>(iter_num, "alpha, shift");
         m_replay_data.emplace_back<util::VdDouble>(iter_num, alpha);
         m_replay_data.emplace_back<util::VdVector>(iter_num, -alpha * grad);
 
+        const double step = alpha;
         alpha = m_alpha;
         curr_vec = std::move(next_vec);
         f_curr = f_next;
+        enter_phase(util::Phase::MatVec);
         grad = func.grad(curr_vec);
+        enter_phase(util::Phase::VectorOps);
+        length = grad.length_pow2();
+        record_iteration(iter_num, length, f_curr, step, 0., evals);
         ++iter_num;
     }
+    enter_phase(util::Phase::Trace);
     m_replay_data.emplace_back<util::VdComment>(iter_num, "x and f(x)");
     m_replay_data.emplace_back<util::VdVector>(iter_num, curr_vec);
     m_replay_data.emplace_back<util::VdDouble>(iter_num, f_curr);
     m_replay_data.emplace_back<util::VdComment>(iter_num, "grad");
     m_replay_data.emplace_back<util::VdVector>(iter_num, grad);
 
-    return {curr_vec, f_curr, m_replay_data};
+    return {{curr_vec, f_curr, std::sqrt(grad.length_pow2())}, m_replay_data};
+}
+
+GradientStepper::GradientStepper(util::Vector start, double eps, double max_step, util::SolveBudget budget)
+    : Stepper(start.dims(), std::move(budget))
+    , m_eps(eps)
+    , m_max_step(max_step)
+    , m_alpha(max_step)
+    , m_curr(start.dims())
+    , m_grad(start.dims())
+{
+    request(std::move(start), true);
+}
+
+/*
+ * The same steps as in Gradient::find_min_impl, but values and gradients are requested instead of calculated.
+ */
+void GradientStepper::tell(const EvalReply & reply)
+{
+    check_reply(reply);
+    switch (m_state) {
+    case State::Start:
+        m_curr = std::move(m_request.points[0]);
+        m_f_curr = reply.values[0];
+        m_grad = reply.gradients[0];
+        m_grad_len_pow2 = m_grad.length_pow2();
+        next();
+        break;
+    case State::Trial:
+        if (reply.values[0] >= m_f_curr && m_alpha > m_eps) {
+            m_alpha /= 2;
+            m_iter_evals++;
+            try_step();
+            break;
+        }
+        m_step = m_alpha;
+        m_alpha = m_max_step;
+        m_f_curr = reply.values[0];
+        request(std::move(m_request.points[0]), true);
+        m_state = State::Gradient;
+        break;
+    case State::Gradient:
+        m_curr = std::move(m_request.points[0]);
+        m_grad = reply.gradients[0];
+        m_grad_len_pow2 = m_grad.length_pow2();
+        record_iteration(m_grad_len_pow2, m_f_curr, m_step, 0., m_iter_evals);
+        next();
+        break;
+    }
+}
+
+void GradientStepper::next()
+{
+    if (m_grad_len_pow2 >= m_eps * m_eps && !budget_exhausted()) {
+        m_iter_evals = 1;
+        try_step();
+    } else {
+        finish(m_curr, m_f_curr, m_grad_len_pow2);
+    }
+}
+
+void GradientStepper::try_step()
+{
+    request(m_curr - m_alpha * m_grad, false);
+    m_state = State::Trial;
 }
 
 } // namespace min_nd
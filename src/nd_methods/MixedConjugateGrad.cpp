@@ -0,0 +1,150 @@
+#include "nd_methods/MixedConjugateGrad.h"
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/DiagMatrix.h"
+#include "util/Vector.h"
+#include "util/VersionedData.h"
+
+#include <cmath>
+
+namespace min_nd {
+/*
+ * Idea: the same as in conjugate gradient method, but vectors that are read on each iteration
+ * (A, p, A * p and gradient) are stored in float, so twice less memory is moved.
+ * Position is accumulated in double. The gradient updated by recurrence drifts from the true one,
+ * so every m_recalc_period iterations, and before exiting, it is recalculated in double from the position.
+ * If the true gradient is still too big, the method is restarted from the current position.
+ */
+SearchRes MixedConjucateGrad::find_min_impl()
+{
+    using FVector = util::BasicVector<float>;
+
+    const double eps_pow2 = m_eps * m_eps;
+    auto & func = curr_func();
+    const util::BasicDiagMatrix<float> a(func.a());
+
+    util::Vector curr = start_point();
+    FVector grad(func.grad(curr));
+    FVector p = grad * -1.;
+
+    double grad_len_pow2 = grad.length_pow2();
+    double f = func(curr); // tracked incrementally for the convergence history
+    double beta = 0.;
+    uint iter_num = 0;
+
+    while (!budget_exhausted(iter_num)) {
+        if (grad_len_pow2 < eps_pow2) {
+            /*
+             * Check convergence with the true gradient.
+             */
+            grad = FVector(func.grad(curr));
+            grad_len_pow2 = grad.length_pow2();
+            if (grad_len_pow2 < eps_pow2) {
+                break;
+            }
+            p = grad * -1.;
+        }
+
+        enter_phase(util::Phase::MatVec);
+        const FVector a_by_p = a * p;
+        enter_phase(util::Phase::VectorOps);
+        double alpha = grad_len_pow2 / a_by_p.dot(p);
+        f -= alpha * grad_len_pow2 / 2;
+
+        curr.add_scaled(alpha, p); // update position in double
+        if ((iter_num + 1) % m_recalc_period == 0) {
+            enter_phase(util::Phase::MatVec);
+            grad = FVector(func.grad(curr)); // recalculate gradient in double
+            enter_phase(util::Phase::VectorOps);
+        } else {
+            grad.add_scaled(alpha, a_by_p);
+        }
+        const double new_len_pow2 = grad.length_pow2();
+        beta = new_len_pow2 / grad_len_pow2;
+        p = beta * p - grad;
+
+        grad_len_pow2 = new_len_pow2;
+        record_iteration(iter_num, grad_len_pow2, f, alpha, beta, 1);
+        iter_num++;
+    }
+
+    return {curr, func(curr), std::sqrt(func.grad(curr).length_pow2())};
+}
+
+/*
+ * Version with tracing output.
+ */
+TracedSearchRes MixedConjucateGrad::find_min_traced_impl()
+{
+    using FVector = util::BasicVector<float>;
+
+    const double eps_pow2 = m_eps * m_eps;
+    auto & func = curr_func();
+    const util::BasicDiagMatrix<float> a(func.a());
+
+    util::Vector curr = start_point();
+    FVector grad(func.grad(curr));
+    FVector p = grad * -1.;
+
+    double grad_len_pow2 = grad.length_pow2();
+    double f = func(curr); // tracked incrementally for the convergence history
+    double beta = 0.;
+    uint iter_num = 0;
+
+    while (!budget_exhausted(iter_num)) {
+        if (grad_len_pow2 < eps_pow2) {
+            grad = FVector(func.grad(curr));
+            grad_len_pow2 = grad.length_pow2();
+            m_replay_data.emplace_back<util::VdComment>(iter_num, "recalculated gradient length");
+            m_replay_data.emplace_back<util::VdDouble>(iter_num, std::sqrt(grad_len_pow2));
+            if (grad_len_pow2 < eps_pow2) {
+                break;
+            }
+            m_replay_data.emplace_back<util::VdComment>(iter_num, "restart");
+            p = grad * -1.;
+        }
+
+        enter_phase(util::Phase::Trace);
+        m_replay_data.emplace_back<util::VdComment>(iter_num, "x, f, grad, p");
+        m_replay_data.emplace_back<util::VdVector>(iter_num, curr);
+        m_replay_data.emplace_back<util::VdDouble>(iter_num, func(curr));
+        m_replay_data.emplace_back<util::VdVector>(iter_num, util::Vector(grad));
+        m_replay_data.emplace_back<util::VdVector>(iter_num, util::Vector(p));
+
+        enter_phase(util::Phase::MatVec);
+        const FVector a_by_p = a * p;
+        enter_phase(util::Phase::VectorOps);
+        double alpha = grad_len_pow2 / a_by_p.dot(p);
+        f -= alpha * grad_len_pow2 / 2;
+        enter_phase(util::Phase::Trace);
+        m_replay_data.emplace_back<util::VdComment>(iter_num, "alpha, beta");
+        m_replay_data.emplace_back<util::VdDouble>(iter_num, alpha);
+        m_replay_data.emplace_back<util::VdDouble>(iter_num, beta);
+
+        enter_phase(util::Phase::VectorOps);
+        curr.add_scaled(alpha, p);
+        if ((iter_num + 1) % m_recalc_period == 0) {
+            grad = FVector(func.grad(curr));
+            m_replay_data.emplace_back<util::VdComment>(iter_num, "gradient recalculated in double");
+        } else {
+            grad.add_scaled(alpha, a_by_p);
+        }
+        const double new_len_pow2 = grad.length_pow2();
+        beta = new_len_pow2 / grad_len_pow2;
+        p = beta * p - grad;
+
+        grad_len_pow2 = new_len_pow2;
+        record_iteration(iter_num, grad_len_pow2, f, alpha, beta, 1);
+        iter_num++;
+    }
+
+    const double residual = std::sqrt(func.grad(curr).length_pow2());
+    m_replay_data.emplace_back<util::VdComment>(iter_num, "x, residual");
+    m_replay_data.emplace_back<util::VdVector>(iter_num, curr);
+    m_replay_data.emplace_back<util::VdDouble>(iter_num, residual);
+
+    return {{curr, func(curr), residual}, m_replay_data};
+}
+
+} // namespace min_nd
@@ -0,0 +1,379 @@
+#include "nd_methods/NelderMead.h"
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/Vector.h"
+#include "util/VersionedData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace min_nd {
+
+namespace {
+
+constexpr double REFLECTION = 1.;
+constexpr double EXPANSION = 2.;
+constexpr double CONTRACTION = 0.5;
+constexpr double SHRINK = 0.5;
+
+/*
+ * What happened to the moved vertices on one iteration.
+ */
+struct StepStats
+{
+    uint reflections = 0;
+    uint expansions = 0;
+    uint contractions = 0;
+    bool shrunk = false;
+    uint evals = 0;
+};
+
+/*
+ * Simplex of n + 1 vertices stored vertex after vertex, with function's values in them.
+ * order sorts the vertices by value, the vertices themselves are never moved in memory.
+ * Sum of all vertices is updated, when a vertex is replaced, so centroids cost O(parallel * n), not O(n^2).
+ */
+struct Simplex
+{
+    Simplex(const util::NFunction & func, const util::Vector & start, double initial_size, std::size_t parallel, util::ThreadPool * pool)
+        : func(func)
+        , pool(pool)
+        , n(start.dims())
+        , moved(std::min(parallel, n))
+        , vertices((n + 1) * n)
+        , values(n + 1)
+        , order(n + 1)
+        , sum(n)
+        , centroid(n)
+        , candidates(moved * n)
+        , candidate_values(moved)
+        , second(moved * n)
+        , second_values(moved)
+        , kinds(moved)
+    {
+        for (std::size_t i = 0; i <= n; ++i) {
+            std::copy(start.data(), start.data() + n, vertex(i));
+            if (i > 0) {
+                vertex(i)[i - 1] += initial_size * std::max(std::abs(start[i - 1]), 1.);
+            }
+        }
+        evaluate(n + 1, [this](std::size_t i) { return vertex(i); }, [this](std::size_t i) -> double & { return values[i]; });
+        std::iota(order.begin(), order.end(), 0);
+        sort();
+        recalc_sum();
+    }
+
+    double * vertex(std::size_t i) noexcept { return &vertices[i * n]; }
+    double * best() noexcept { return vertex(order[0]); }
+    util::Vector best_point() { return util::Vector(std::vector<double>(best(), best() + n)); }
+    double best_value() const noexcept { return values[order[0]]; }
+    double spread() const noexcept { return values[order[n]] - values[order[0]]; }
+
+    /*
+     * Largest distance (in max-norm) from the best vertex to the others.
+     */
+    double size() noexcept
+    {
+        const double * b = best();
+        double res = 0.;
+        for (std::size_t i = 1; i <= n; ++i) {
+            const double * v = vertex(order[i]);
+            for (std::size_t j = 0; j < n; ++j) {
+                res = std::max(res, std::abs(v[j] - b[j]));
+            }
+        }
+        return res;
+    }
+
+    bool converged(double eps) noexcept { return spread() <= eps && size() <= eps; }
+
+    /*
+     * One iteration of the parallel method, enter_phase(phase) is called before each part of it.
+     */
+    template <class EnterPhase>
+    StepStats step(EnterPhase && enter_phase)
+    {
+        enum Kind
+        {
+            Accepted,
+            Expansion,
+            OutsideContraction,
+            InsideContraction,
+        };
+
+        StepStats stats;
+        const std::size_t keep = n + 1 - moved;
+
+        enter_phase(util::Phase::VectorOps);
+        for (std::size_t j = 0; j < n; ++j) {
+            centroid[j] = sum[j];
+        }
+        for (std::size_t k = 0; k < moved; ++k) {
+            const double * w = vertex(order[keep + k]);
+            for (std::size_t j = 0; j < n; ++j) {
+                centroid[j] -= w[j];
+            }
+        }
+        for (std::size_t j = 0; j < n; ++j) {
+            centroid[j] /= static_cast<double>(keep);
+        }
+        for (std::size_t k = 0; k < moved; ++k) {
+            combine(candidate(k), vertex(order[keep + k]), -REFLECTION);
+        }
+
+        enter_phase(util::Phase::MatVec);
+        evaluate(moved, [this](std::size_t k) { return candidate(k); }, [this](std::size_t k) -> double & { return candidate_values[k]; });
+        stats.evals += moved;
+
+        /*
+         * Each moved vertex is treated as in the classic method, where the worst of the kept vertices plays the second worst.
+         */
+        enter_phase(util::Phase::VectorOps);
+        const double f_best = values[order[0]];
+        const double f_kept_worst = values[order[keep - 1]];
+        std::size_t second_count = 0;
+        for (std::size_t k = 0; k < moved; ++k) {
+            const double f_r = candidate_values[k];
+            const double f_w = values[order[keep + k]];
+            if (f_r < f_best) {
+                kinds[k] = Expansion;
+                combine(second_candidate(second_count), candidate(k), EXPANSION);
+            } else if (f_r < f_kept_worst) {
+                kinds[k] = Accepted;
+                continue;
+            } else if (f_r < f_w) {
+                kinds[k] = OutsideContraction;
+                combine(second_candidate(second_count), candidate(k), CONTRACTION);
+            } else {
+                kinds[k] = InsideContraction;
+                combine(second_candidate(second_count), vertex(order[keep + k]), CONTRACTION);
+            }
+            ++second_count;
+        }
+
+        enter_phase(util::Phase::MatVec);
+        evaluate(second_count, [this](std::size_t k) { return second_candidate(k); }, [this](std::size_t k) -> double & { return second_values[k]; });
+        stats.evals += second_count;
+
+        enter_phase(util::Phase::VectorOps);
+        bool any_moved = false;
+        for (std::size_t k = 0, s = 0; k < moved; ++k) {
+            const std::size_t idx = order[keep + k];
+            const double f_r = candidate_values[k];
+            switch (kinds[k]) {
+            case Accepted:
+                replace(idx, candidate(k), f_r);
+                ++stats.reflections;
+                any_moved = true;
+                continue;
+            case Expansion:
+                if (second_values[s] < f_r) {
+                    replace(idx, second_candidate(s), second_values[s]);
+                    ++stats.expansions;
+                } else {
+                    replace(idx, candidate(k), f_r);
+                    ++stats.reflections;
+                }
+                any_moved = true;
+                break;
+            case OutsideContraction:
+            case InsideContraction: {
+                const bool is_better = kinds[k] == OutsideContraction ? second_values[s] <= f_r : second_values[s] < values[idx];
+                if (is_better) {
+                    replace(idx, second_candidate(s), second_values[s]);
+                    ++stats.contractions;
+                    any_moved = true;
+                }
+                break;
+            }
+            }
+            ++s;
+        }
+
+        if (!any_moved) {
+            shrink();
+            enter_phase(util::Phase::MatVec);
+            evaluate(n, [this](std::size_t i) { return vertex(order[i + 1]); }, [this](std::size_t i) -> double & { return values[order[i + 1]]; });
+            stats.shrunk = true;
+            stats.evals += n;
+            enter_phase(util::Phase::VectorOps);
+            recalc_sum();
+        } else if (++since_recalc > n) {
+            recalc_sum(); // drop the error accumulated by the incremental updates
+        }
+        sort();
+        return stats;
+    }
+
+private:
+    double * candidate(std::size_t k) noexcept { return &candidates[k * n]; }
+    double * second_candidate(std::size_t k) noexcept { return &second[k * n]; }
+
+    /*
+     * to = centroid + coef * (from - centroid).
+     */
+    void combine(double * to, const double * from, double coef) noexcept
+    {
+        for (std::size_t j = 0; j < n; ++j) {
+            to[j] = centroid[j] + coef * (from[j] - centroid[j]);
+        }
+    }
+
+    void replace(std::size_t idx, const double * point, double value) noexcept
+    {
+        double * v = vertex(idx);
+        for (std::size_t j = 0; j < n; ++j) {
+            sum[j] += point[j] - v[j];
+            v[j] = point[j];
+        }
+        values[idx] = value;
+    }
+
+    /*
+     * Move all vertices half way to the best one.
+     */
+    void shrink() noexcept
+    {
+        const double * b = best();
+        for (std::size_t i = 1; i <= n; ++i) {
+            double * v = vertex(order[i]);
+            for (std::size_t j = 0; j < n; ++j) {
+                v[j] = b[j] + SHRINK * (v[j] - b[j]);
+            }
+        }
+    }
+
+    void recalc_sum() noexcept
+    {
+        std::fill(sum.begin(), sum.end(), 0.);
+        for (std::size_t i = 0; i <= n; ++i) {
+            const double * v = vertex(i);
+            for (std::size_t j = 0; j < n; ++j) {
+                sum[j] += v[j];
+            }
+        }
+        since_recalc = 0;
+    }
+
+    void sort()
+    {
+        std::stable_sort(order.begin(), order.end(), [this](std::size_t lhs, std::size_t rhs) { return values[lhs] < values[rhs]; });
+    }
+
+    /*
+     * value(i) = func(point(i)) for i in [0, count), evaluated concurrently, if there is a pool.
+     */
+    template <class Point, class Value>
+    void evaluate(std::size_t count, Point && point, Value && value)
+    {
+        auto eval = [&](std::size_t i) {
+            const double * x = point(i);
+            value(i) = func(util::Vector(std::vector<double>(x, x + n)));
+        };
+        if (pool != nullptr) {
+            pool->parallel_for(count, eval);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                eval(i);
+            }
+        }
+    }
+
+public:
+    const util::NFunction & func;
+    util::ThreadPool * pool;
+    const std::size_t n;
+    const std::size_t moved; // number of vertices moved on each iteration
+    std::vector<double> vertices;
+    std::vector<double> values;
+    std::vector<std::size_t> order;
+    std::vector<double> sum;
+    std::vector<double> centroid;
+    std::vector<double> candidates; // reflections of the moved vertices
+    std::vector<double> candidate_values;
+    std::vector<double> second; // expansions or contractions, where they are needed
+    std::vector<double> second_values;
+    std::vector<int> kinds;
+    std::size_t since_recalc = 0;
+};
+
+} // anonymous namespace
+
+/*
+ * Idea: the simplex of n + 1 points is moved away from the worst values:
+ * the worst vertices are reflected through the rest of the simplex, the reflection is expanded, if it is better than all,
+ * or contracted, if it is not better than the kept vertices. When no vertex could be moved, the simplex shrinks to the best vertex.
+ * Exit, when both the values and the vertices of the simplex differ less than required precision.
+ * Gradient is calculated only for the history and to report the residual, the search itself uses values.
+ */
+SearchRes NelderMead::find_min_impl()
+{
+    auto & func = curr_func();
+    Simplex simplex(func, start_point(), m_initial_size, m_parallel, m_pool);
+    auto enter = [this](util::Phase phase) { enter_phase(phase); };
+
+    uint iter_num = 0;
+    while (!simplex.converged(m_eps) && !budget_exhausted(iter_num)) {
+        const auto stats = simplex.step(enter);
+        enter_phase(util::Phase::MatVec);
+        record_iteration(iter_num, func.grad(simplex.best_point()).length_pow2(), simplex.best_value(), 0., 0., stats.evals);
+        iter_num++;
+    }
+
+    const util::Vector best = simplex.best_point();
+    enter_phase(util::Phase::MatVec);
+    const double residual = std::sqrt(func.grad(best).length_pow2());
+    return {best, simplex.best_value(), residual};
+}
+
+/*
+ * Version with tracing output.
+ */
+TracedSearchRes NelderMead::find_min_traced_impl()
+{
+    auto & func = curr_func();
+    Simplex simplex(func, start_point(), m_initial_size, m_parallel, m_pool);
+    auto enter = [this](util::Phase phase) { enter_phase(phase); };
+
+    enter_phase(util::Phase::Trace);
+    m_replay_data.emplace_back<util::VdComment>(0, "vertices moved on each iteration");
+    m_replay_data.emplace_back<util::VdDouble>(0, static_cast<double>(simplex.moved));
+
+    uint iter_num = 0;
+    while (!simplex.converged(m_eps) && !budget_exhausted(iter_num)) {
+        enter_phase(util::Phase::Trace);
+        m_replay_data.emplace_back<util::VdComment>(iter_num, "best vertex, its value and spread of values");
+        m_replay_data.emplace_back<util::VdVector>(iter_num, simplex.best_point());
+        m_replay_data.emplace_back<util::VdDouble>(iter_num, simplex.best_value());
+        m_replay_data.emplace_back<util::VdDouble>(iter_num, simplex.spread());
+
+        const auto stats = simplex.step(enter);
+        enter_phase(util::Phase::Trace);
+        if (stats.shrunk) {
+            m_replay_data.emplace_back<util::VdComment>(iter_num, "no vertex improved, simplex shrunk");
+        } else {
+            m_replay_data.emplace_back<util::VdComment>(iter_num, "reflections, expansions, contractions");
+            m_replay_data.emplace_back<util::VdDouble>(iter_num, stats.reflections);
+            m_replay_data.emplace_back<util::VdDouble>(iter_num, stats.expansions);
+            m_replay_data.emplace_back<util::VdDouble>(iter_num, stats.contractions);
+        }
+        enter_phase(util::Phase::MatVec);
+        record_iteration(iter_num, func.grad(simplex.best_point()).length_pow2(), simplex.best_value(), 0., 0., stats.evals);
+        iter_num++;
+    }
+
+    const util::Vector best = simplex.best_point();
+    enter_phase(util::Phase::MatVec);
+    const double residual = std::sqrt(func.grad(best).length_pow2());
+    enter_phase(util::Phase::Trace);
+    m_replay_data.emplace_back<util::VdComment>(iter_num, "x, f(x)");
+    m_replay_data.emplace_back<util::VdVector>(iter_num, best);
+    m_replay_data.emplace_back<util::VdDouble>(iter_num, simplex.best_value());
+
+    return {{best, simplex.best_value(), residual}, m_replay_data};
+}
+
+} // namespace min_nd
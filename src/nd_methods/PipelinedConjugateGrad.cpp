@@ -0,0 +1,199 @@
+#include "nd_methods/PipelinedConjugateGrad.h"
+
+#include "nd_methods/MinSearcher.h"
+
+#include "util/Vector.h"
+#include "util/VersionedData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace min_nd {
+
+namespace {
+
+/*
+ * Vectors of the pipelined method.
+ * r = -grad is the residual, w = A * r, q = A * w,
+ * p is the conjugate direction, s = A * p, z = A * s.
+ */
+struct PipelinedState
+{
+    PipelinedState(const util::NFunction & func, util::Vector start)
+        : diag(func.a().data())
+        , b(func.b().data())
+        , x(std::move(start).take_data())
+        , r(func.dims())
+        , w(func.dims())
+        , q(func.dims())
+        , p(func.dims())
+        , s(func.dims())
+        , z(func.dims())
+    {
+        restart();
+    }
+
+    /*
+     * Drop the conjugate direction and calculate the residual from the position.
+     */
+    void restart()
+    {
+        std::fill(p.begin(), p.end(), 0.);
+        replace_residual();
+        is_first = true;
+    }
+
+    /*
+     * Recalculate the residual and all matrix products from the position and the direction,
+     * so that the error accumulated by recurrences is dropped.
+     */
+    void replace_residual()
+    {
+        gamma = delta = 0.;
+        for (std::size_t j = 0; j < x.size(); ++j) {
+            r[j] = -(diag[j] * x[j] + b[j]);
+            w[j] = diag[j] * r[j];
+            q[j] = diag[j] * w[j];
+            s[j] = diag[j] * p[j];
+            z[j] = diag[j] * s[j];
+            gamma += r[j] * r[j];
+            delta += w[j] * r[j];
+        }
+    }
+
+    /*
+     * Compute alpha and beta from the reduction of the previous pass.
+     */
+    void count_coefficients()
+    {
+        if (is_first) {
+            beta = 0.;
+            alpha = gamma / delta;
+            is_first = false;
+        } else {
+            beta = gamma / prev_gamma;
+            alpha = gamma / (delta - beta * gamma / alpha);
+        }
+        prev_gamma = gamma;
+    }
+
+    /*
+     * One pass over the data: update directions, position and residual,
+     * compute the next q = A * w and the reduction (r, r), (w, r) for the next iteration.
+     */
+    void step()
+    {
+        double next_gamma = 0.;
+        double next_delta = 0.;
+        for (std::size_t j = 0; j < x.size(); ++j) {
+            z[j] = q[j] + beta * z[j];
+            s[j] = w[j] + beta * s[j];
+            p[j] = r[j] + beta * p[j];
+            x[j] += alpha * p[j];
+            r[j] -= alpha * s[j];
+            w[j] -= alpha * z[j];
+            q[j] = diag[j] * w[j];
+            next_gamma += r[j] * r[j];
+            next_delta += w[j] * r[j];
+        }
+        gamma = next_gamma;
+        delta = next_delta;
+    }
+
+    const double * diag;
+    const double * b;
+    std::vector<double> x, r, w, q, p, s, z;
+    double gamma = 0., delta = 0., prev_gamma = 0.;
+    double alpha = 0., beta = 0.;
+    bool is_first = true;
+};
+
+} // anonymous namespace
+
+/*
+ * Idea: the same as in conjugate gradient method, but the recurrences are rearranged,
+ * so that alpha and beta depend only on (r, r) and (w, r), which are known before the iteration starts.
+ * As the matrix is diagonal, the whole iteration becomes one pass with one fused reduction,
+ * so there is one synchronization point per iteration instead of two.
+ * Recurrences accumulate error faster than in the classic method,
+ * so every m_recalc_period iterations, and before exiting, the residual is recalculated from the position.
+ */
+SearchRes PipelinedConjucateGrad::find_min_impl()
+{
+    const double eps_pow2 = m_eps * m_eps;
+    auto & func = curr_func();
+
+    auto start = start_point();
+    double f = func(start); // tracked incrementally for the convergence history
+    PipelinedState st(func, std::move(start));
+    uint iter_num = 0;
+    while (!budget_exhausted(iter_num)) {
+        if (st.gamma < eps_pow2 || (iter_num > 0 && iter_num % m_recalc_period == 0)) {
+            st.replace_residual();
+            if (st.gamma < eps_pow2) {
+                break;
+            }
+        }
+
+        st.count_coefficients();
+        f -= st.alpha * st.gamma / 2;
+        enter_phase(util::Phase::MatVec); // the fused pass does all the vector work of the iteration
+        st.step();
+        record_iteration(iter_num, st.gamma, f, st.alpha, st.beta, 1);
+        iter_num++;
+    }
+
+    util::Vector curr(std::move(st.x));
+    return {curr, func(curr), std::sqrt(func.grad(curr).length_pow2())};
+}
+
+/*
+ * Version with tracing output.
+ */
+TracedSearchRes PipelinedConjucateGrad::find_min_traced_impl()
+{
+    const double eps_pow2 = m_eps * m_eps;
+    auto & func = curr_func();
+
+    auto start = start_point();
+    double f = func(start); // tracked incrementally for the convergence history
+    PipelinedState st(func, std::move(start));
+    uint iter_num = 0;
+    while (!budget_exhausted(iter_num)) {
+        if (st.gamma < eps_pow2 || (iter_num > 0 && iter_num % m_recalc_period == 0)) {
+            st.replace_residual();
+            m_replay_data.emplace_back<util::VdComment>(iter_num, "residual recalculated, its length");
+            m_replay_data.emplace_back<util::VdDouble>(iter_num, std::sqrt(st.gamma));
+            if (st.gamma < eps_pow2) {
+                break;
+            }
+        }
+
+        enter_phase(util::Phase::Trace);
+        m_replay_data.emplace_back<util::VdComment>(iter_num, "x, residual");
+        m_replay_data.emplace_back<util::VdVector>(iter_num, util::Vector(st.x));
+        m_replay_data.emplace_back<util::VdVector>(iter_num, util::Vector(st.r));
+
+        st.count_coefficients();
+        m_replay_data.emplace_back<util::VdComment>(iter_num, "alpha, beta");
+        m_replay_data.emplace_back<util::VdDouble>(iter_num, st.alpha);
+        m_replay_data.emplace_back<util::VdDouble>(iter_num, st.beta);
+
+        f -= st.alpha * st.gamma / 2;
+        enter_phase(util::Phase::MatVec);
+        st.step();
+        record_iteration(iter_num, st.gamma, f, st.alpha, st.beta, 1);
+        iter_num++;
+    }
+
+    util::Vector curr(std::move(st.x));
+    const double residual = std::sqrt(func.grad(curr).length_pow2());
+    m_replay_data.emplace_back<util::VdComment>(iter_num, "x, residual length");
+    m_replay_data.emplace_back<util::VdVector>(iter_num, curr);
+    m_replay_data.emplace_back<util::VdDouble>(iter_num, residual);
+
+    return {{curr, func(curr), residual}, m_replay_data};
+}
+
+} // namespace min_nd
@@ -0,0 +1,49 @@
+#include "sd_methods/BatchDichotomy.h"
+
+#include <vector>
+
+namespace min1d {
+
+BatchSearchRes BatchDichotomy::find_min_impl() /*override*/
+{
+    const auto & fn = last_func();
+    const std::size_t size = fn.size();
+
+    /*
+     * Same algorithm as in Dichotomy. On each iteration points x_left and x_right
+     * of all active lanes are calculated, after that every active lane chooses its next segment.
+     * A lane becomes inactive, when its segment's length is less than epsilon.
+     */
+    std::vector<double> from(fn.from()), to(fn.to());
+    std::vector<double> x_left(size), x_right(size), f_left(size), f_right(size);
+    std::vector<char> active(size);
+
+    for (;;) {
+        std::size_t active_cnt = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            active[i] = (to[i] - from[i]) > m_eps;
+            active_cnt += active[i];
+
+            const double mid = (from[i] + to[i]) / 2;
+            x_left[i] = mid - m_sigma;
+            x_right[i] = mid + m_sigma;
+        }
+        if (active_cnt == 0) {
+            break;
+        }
+
+        calculate_active(x_left, f_left, active);
+        calculate_active(x_right, f_right, active);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            const bool on = active[i];
+            const bool left = f_left[i] < f_right[i];
+            to[i] = (on && left) ? x_right[i] : to[i];
+            from[i] = (on && !left) ? x_left[i] : from[i];
+        }
+    }
+
+    return calculate_middles(from, to);
+}
+
+} // namespace min1d
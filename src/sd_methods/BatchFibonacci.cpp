@@ -0,0 +1,94 @@
+#include "sd_methods/BatchFibonacci.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace min1d {
+
+BatchSearchRes BatchFibonacci::find_min_impl() /*override*/
+{
+    const auto & fn = last_func();
+    const std::size_t size = fn.size();
+    std::vector<double> from(fn.from()), to(fn.to());
+
+    /*
+     * Every lane needs its own number of iterations, as its segment has its own length.
+     * Count fibonacci numbers once, up to the biggest limit of the batch,
+     * and for each lane find n, such that (b_0 - a_0) / epsilon < F_n.
+     */
+    double max_limit = 0.;
+    for (std::size_t i = 0; i < size; ++i) {
+        max_limit = std::max(max_limit, (to[i] - from[i]) / m_eps);
+    }
+    std::vector<double> fib = {1, 1}; // type is "double" to avoid casts in future
+    while (fib.back() < max_limit) {
+        fib.emplace_back(fib[fib.size() - 1] + fib[fib.size() - 2]);
+    }
+
+    std::vector<std::size_t> n(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        const double limit = (to[i] - from[i]) / m_eps;
+        n[i] = std::max<std::size_t>(std::lower_bound(fib.begin(), fib.end(), limit) - fib.begin(), 2);
+    }
+
+    std::vector<double> x_left(size), x_right(size), f_left(size), f_right(size);
+    std::vector<char> active(size, 1), goes_right(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        const double len = to[i] - from[i];
+        x_left[i] = from[i] + fib[n[i] - 2] / fib[n[i]] * len;
+        x_right[i] = from[i] + fib[n[i] - 1] / fib[n[i]] * len;
+    }
+    calculate_active(x_left, f_left, active);
+    calculate_active(x_right, f_right, active);
+
+    /*
+     * Iterations go as in Fibonacci, lane i is active while k < n_i - 2.
+     */
+    std::vector<double> x_new(size), f_new(size);
+    for (std::size_t k = 1;; k++) {
+        std::size_t active_cnt = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            active[i] = k + 2 < n[i];
+            active_cnt += active[i];
+        }
+        if (active_cnt == 0) {
+            break;
+        }
+
+        for (std::size_t i = 0; i < size; ++i) {
+            const bool on = active[i];
+            if (!on) {
+                continue;
+            }
+            const bool right = f_left[i] > f_right[i];
+            goes_right[i] = right;
+
+            const double new_from = right ? x_left[i] : from[i];
+            const double new_to = right ? to[i] : x_right[i];
+            const double len = new_to - new_from;
+            const double new_left = right ? x_right[i] : (new_from + fib[n[i] - k - 2] / fib[n[i] - k] * len);
+            const double new_right = right ? (new_from + fib[n[i] - k - 1] / fib[n[i] - k] * len) : x_left[i];
+            const double new_f = right ? f_right[i] : f_left[i];
+
+            from[i] = new_from;
+            to[i] = new_to;
+            x_left[i] = new_left;
+            x_right[i] = new_right;
+            f_left[i] = new_f;
+            f_right[i] = new_f;
+            x_new[i] = right ? new_right : new_left;
+        }
+
+        calculate_active(x_new, f_new, active);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            const bool on = active[i];
+            f_right[i] = (on && goes_right[i]) ? f_new[i] : f_right[i];
+            f_left[i] = (on && !goes_right[i]) ? f_new[i] : f_left[i];
+        }
+    }
+
+    return calculate_middles(from, to);
+}
+
+} // namespace min1d
@@ -0,0 +1,81 @@
+#include "sd_methods/BatchGolden.h"
+
+#include <vector>
+
+namespace min1d {
+
+BatchSearchRes BatchGolden::find_min_impl() /*override*/
+{
+    const auto & fn = last_func();
+    const std::size_t size = fn.size();
+
+    /*
+     * Same algorithm as in Golden, but every lane keeps its own segment and its own points.
+     * Lane's state is stored in separate arrays, so the loops below have no branches
+     * and can be vectorized by the compiler.
+     * On each iteration every active lane chooses the next segment, saves one point
+     * and produces one new point. New points of all active lanes are calculated with one callback call.
+     * A lane becomes inactive, when its segment's length is less than epsilon.
+     */
+    std::vector<double> from(fn.from()), to(fn.to());
+    std::vector<double> x_left(size), x_right(size), f_left(size), f_right(size);
+    std::vector<char> active(size), goes_right(size);
+
+    for (std::size_t i = 0; i < size; ++i) {
+        const double len = to[i] - from[i];
+        x_left[i] = to[i] - TAU * len;
+        x_right[i] = from[i] + TAU * len;
+        active[i] = 1;
+    }
+    calculate_active(x_left, f_left, active);
+    calculate_active(x_right, f_right, active);
+
+    std::vector<double> x_new(size), f_new(size);
+    for (;;) {
+        std::size_t active_cnt = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            active[i] = (to[i] - from[i]) > m_eps;
+            active_cnt += active[i];
+        }
+        if (active_cnt == 0) {
+            break;
+        }
+
+        for (std::size_t i = 0; i < size; ++i) {
+            const bool right = f_left[i] > f_right[i];
+            const bool on = active[i];
+            goes_right[i] = right;
+
+            /*
+             * right: proceed with [x_left, b], x_right becomes x_left
+             * left:  proceed with [a, x_right], x_left becomes x_right
+             */
+            const double new_from = right ? x_left[i] : from[i];
+            const double new_to = right ? to[i] : x_right[i];
+            const double new_left = right ? x_right[i] : (new_to - TAU * (new_to - new_from));
+            const double new_right = right ? (new_from + TAU * (new_to - new_from)) : x_left[i];
+            const double new_f_left = right ? f_right[i] : f_left[i];
+            const double new_f_right = right ? f_right[i] : f_left[i];
+
+            from[i] = on ? new_from : from[i];
+            to[i] = on ? new_to : to[i];
+            x_left[i] = on ? new_left : x_left[i];
+            x_right[i] = on ? new_right : x_right[i];
+            f_left[i] = on ? new_f_left : f_left[i];
+            f_right[i] = on ? new_f_right : f_right[i];
+            x_new[i] = right ? new_right : new_left;
+        }
+
+        calculate_active(x_new, f_new, active);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            const bool on = active[i];
+            f_right[i] = (on && goes_right[i]) ? f_new[i] : f_right[i];
+            f_left[i] = (on && !goes_right[i]) ? f_new[i] : f_left[i];
+        }
+    }
+
+    return calculate_middles(from, to);
+}
+
+} // namespace min1d
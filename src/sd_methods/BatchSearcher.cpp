@@ -0,0 +1,52 @@
+#include "sd_methods/BatchSearcher.h"
+
+#include <numeric>
+
+namespace min1d {
+
+std::size_t BatchSearcher::calculate_active(const std::vector<double> & xs, std::vector<double> & ys, const std::vector<char> & active)
+{
+    const auto & fn = last_func();
+    const std::size_t size = fn.size();
+
+    /*
+     * Compact active lanes, so the callback gets dense arrays.
+     */
+    m_lanes.resize(size);
+    m_xs.resize(size);
+    m_ys.resize(size);
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        m_lanes[count] = i;
+        m_xs[count] = xs[i];
+        count += active[i] != 0;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    fn(m_lanes.data(), m_xs.data(), m_ys.data(), count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        ys[m_lanes[i]] = m_ys[i];
+    }
+    return count;
+}
+
+BatchSearchRes BatchSearcher::calculate_middles(const std::vector<double> & from, const std::vector<double> & to)
+{
+    const std::size_t size = from.size();
+    BatchSearchRes res{std::vector<double>(size), std::vector<double>(size)};
+    for (std::size_t i = 0; i < size; ++i) {
+        res.min_point[i] = (from[i] + to[i]) / 2;
+    }
+
+    m_lanes.resize(size);
+    std::iota(m_lanes.begin(), m_lanes.end(), std::size_t{0});
+    if (size > 0) {
+        last_func()(m_lanes.data(), res.min_point.data(), res.min.data(), size);
+    }
+    return res;
+}
+
+} // namespace min1d
@@ -40,7 +40,6 @@ SearchRes Brent::find_min_impl() noexcept /*override*/
 {
     const auto & fn = last_func();
     auto bnds = fn.bounds();
-    const uint ITER_MAX = 100;
 
     /*
      * Start with finding three points x, w, v that will be used in constructing parabola and function values in this points.
@@ -57,7 +56,7 @@ SearchRes Brent::find_min_impl() noexcept /*override*/
 
     double step, prev_step;
     step = prev_step = bnds.length();
-    for (uint iter = 0; iter < ITER_MAX; iter++) {
+    for (uint iter = 0; !budget_exhausted(iter); iter++) {
         double prev_prev_step = prev_step;
         prev_step = step;
         double to_leave = m_eps * std::abs(x) + m_eps / 10;
@@ -162,7 +161,6 @@ TracedSearchRes Brent::find_min_tracked_impl() noexcept /*override*/
 
     const auto & fn = last_func();
     auto bnds = fn.bounds();
-    const uint ITER_MAX = 100;
     uint iter_num = 0;
 
     double x, w, v;
@@ -172,7 +170,7 @@ TracedSearchRes Brent::find_min_tracked_impl() noexcept /*override*/
 
     double step, prev_step;
     step = prev_step = bnds.length();
-    for (; iter_num < ITER_MAX; iter_num++) {
+    for (; !budget_exhausted(iter_num); iter_num++) {
         m_replay_data.emplace_back<VdComment>(iter_num, "Points a, c, x, w, v are:");
         m_replay_data.emplace_back<VdPoint>(iter_num, bnds.from, fn(bnds.from));
         m_replay_data.emplace_back<VdPoint>(iter_num, bnds.to, fn(bnds.to));
@@ -263,7 +261,102 @@ TracedSearchRes Brent::find_min_tracked_impl() noexcept /*override*/
 
     m_replay_data.emplace_back<VdComment>(iter_num, "Answer is");
     m_replay_data.emplace_back<VdPoint>(iter_num, x, fn(x));
-    return {x, f_x, m_replay_data};
+    return {{x, f_x}, m_replay_data};
+}
+
+BrentStepper::BrentStepper(util::Function::Bounds bounds, double eps, util::SolveBudget budget)
+    : Stepper(std::move(budget))
+    , m_bnds(bounds)
+    , m_eps(eps)
+    , m_x(bounds.from + Brent::TAU * bounds.length())
+    , m_w(m_x)
+    , m_v(m_x)
+    , m_step(bounds.length())
+    , m_prev_step(m_step)
+{
+    request(m_x);
+}
+
+void BrentStepper::tell(const std::vector<double> & values)
+{
+    accept(values);
+    if (!m_started) {
+        m_f_x = m_f_w = m_f_v = values[0];
+        m_started = true;
+    } else {
+        update(values[0]);
+        m_iter++;
+    }
+    next();
+}
+
+/*
+ * The same steps as in Brent::find_min_impl, but u is requested instead of calculated.
+ */
+void BrentStepper::next()
+{
+    if (budget_exhausted()) {
+        finish(m_x, m_f_x);
+        return;
+    }
+    const double prev_prev_step = m_prev_step;
+    m_prev_step = m_step;
+    const double to_leave = m_eps * std::abs(m_x) + m_eps / 10;
+    if (std::abs(m_x - m_bnds.middle()) + m_bnds.length() / 2 - 2 * to_leave <= m_eps) {
+        finish(m_x, m_f_x);
+        return;
+    }
+
+    double u = 0.;
+    bool is_accepted = false;
+    if (all_different(m_x, m_w, m_v, m_eps) && all_different(m_f_x, m_f_w, m_f_v, m_eps)) {
+        u = count_parabole({m_x, m_f_x}, {m_w, m_f_w}, {m_v, m_f_v});
+        if (m_bnds.from + m_eps <= u && u <= m_bnds.to - m_eps && std::abs(u - m_x) < prev_prev_step / 2) {
+            is_accepted = true;
+            if (u - m_bnds.from < 2 * to_leave || m_bnds.to - u < 2 * to_leave) {
+                u = m_x - sign(m_x - m_bnds.middle()) * to_leave;
+            }
+        }
+    }
+    if (!is_accepted) {
+        u = m_x < m_bnds.middle() ? m_x + Brent::TAU * (m_bnds.to - m_x) : m_x - Brent::TAU * (m_x - m_bnds.from);
+    }
+    m_step = std::abs(u - m_x);
+    m_u = u;
+    request(u);
+}
+
+void BrentStepper::update(double f_u) noexcept
+{
+    const double u = m_u;
+    if (f_u <= m_f_x) {
+        if (u >= m_x) {
+            m_bnds.from = m_x;
+        } else {
+            m_bnds.to = m_x;
+        }
+        m_v = m_w;
+        m_w = m_x;
+        m_x = u;
+        m_f_v = m_f_w;
+        m_f_w = m_f_x;
+        m_f_x = f_u;
+    } else {
+        if (u >= m_x) {
+            m_bnds.to = u;
+        } else {
+            m_bnds.from = u;
+        }
+        if (f_u <= m_f_w || m_w == m_x) {
+            m_v = m_w;
+            m_w = u;
+            m_f_v = m_f_w;
+            m_f_w = f_u;
+        } else if (f_u <= m_f_v || m_v == m_x || m_v == m_w) {
+            m_v = u;
+            m_f_v = f_u;
+        }
+    }
 }
 
 } // namespace min1d
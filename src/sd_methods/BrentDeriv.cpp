@@ -0,0 +1,211 @@
+#include "sd_methods/BrentDeriv.h"
+
+#include "sd_methods/MinSearcher.h"
+
+#include "util/ReplayData.h"
+#include "util/VersionedData.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace min1d {
+/*
+ * Helper functions for Brent's method with derivatives.
+ */
+namespace {
+
+/*
+ * Point with function's value and derivative in it.
+ */
+struct Probe
+{
+    double x, f, df;
+};
+
+Probe probe(const util::Function & fn, double x)
+{
+    return {x, fn(x), fn.derivative(x)};
+}
+
+/*
+ * Step of length |len| in the direction of dir.
+ */
+double directed(double len, double dir)
+{
+    return std::signbit(dir) ? -std::abs(len) : std::abs(len);
+}
+
+/*
+ * Choose the next step from point x.
+ * Try secant steps (zeros of derivative's linear interpolation) through x and w, and through x and v.
+ * Accept those that lie within the segment and go downhill; if the chosen one is not smaller than
+ * a half of the step before previous, fall back to bisection of the part of the segment, where derivative points to.
+ * Returns true, if secant step was accepted.
+ */
+bool next_step(util::Function::Bounds bnds, const Probe & x, const Probe & w, const Probe & v, double to_leave, double & step, double & prev_step)
+{
+    const double tol2 = 2 * to_leave;
+    auto bisect = [&] {
+        prev_step = x.df >= 0 ? bnds.from - x.x : bnds.to - x.x;
+        step = prev_step / 2;
+        return false;
+    };
+
+    if (std::abs(prev_step) <= to_leave) {
+        return bisect();
+    }
+
+    double d1 = 2 * bnds.length();
+    double d2 = d1;
+    if (w.df != x.df) {
+        d1 = (w.x - x.x) * x.df / (x.df - w.df);
+    }
+    if (v.df != x.df) {
+        d2 = (v.x - x.x) * x.df / (x.df - v.df);
+    }
+    const double u1 = x.x + d1;
+    const double u2 = x.x + d2;
+    const bool ok1 = (bnds.from - u1) * (u1 - bnds.to) > 0 && x.df * d1 <= 0;
+    const bool ok2 = (bnds.from - u2) * (u2 - bnds.to) > 0 && x.df * d2 <= 0;
+
+    const double prev_prev_step = prev_step;
+    prev_step = step;
+    if (!ok1 && !ok2) {
+        return bisect();
+    }
+
+    const double d = (ok1 && ok2) ? (std::abs(d1) < std::abs(d2) ? d1 : d2) : (ok1 ? d1 : d2);
+    if (std::abs(d) > std::abs(prev_prev_step / 2)) {
+        return bisect();
+    }
+
+    step = d;
+    const double u = x.x + d;
+    if (u - bnds.from < tol2 || bnds.to - u < tol2) {
+        step = directed(to_leave, bnds.middle() - x.x);
+    }
+    return true;
+}
+
+/*
+ * Narrow the segment and update points x, w, v according to new point u.
+ */
+void update(util::Function::Bounds & bnds, Probe & x, Probe & w, Probe & v, const Probe & u)
+{
+    if (u.f <= x.f) {
+        if (u.x >= x.x) {
+            bnds.from = x.x;
+        } else {
+            bnds.to = x.x;
+        }
+        v = w;
+        w = x;
+        x = u;
+    } else {
+        if (u.x < x.x) {
+            bnds.from = u.x;
+        } else {
+            bnds.to = u.x;
+        }
+        if (u.f <= w.f || w.x == x.x) {
+            v = w;
+            w = u;
+        } else if (u.f < v.f || v.x == x.x || v.x == w.x) {
+            v = u;
+        }
+    }
+}
+
+} // anonymous namespace
+
+SearchRes BrentDeriv::find_min_impl() noexcept /*override*/
+{
+    const auto & fn = last_func();
+    assert(fn.has_derivative() && "BrentDeriv requires function with derivative");
+    auto bnds = fn.bounds();
+
+    /*
+     * Same as Brent's method, but instead of parabola through x, w, v
+     * use secant steps on derivative: derivative's values in x and w (or x and v) give the point, where it is zero.
+     * Derivative's sign also tells, which part of the segment should be bisected when secant step is not accepted.
+     * Step shorter than required accuracy is enlarged to it; if it does not decrease the function, x is the answer.
+     */
+    Probe x = probe(fn, bnds.from + TAU * bnds.length());
+    Probe w = x, v = x;
+    double step = 0., prev_step = 0.;
+    for (uint iter = 0; !budget_exhausted(iter); iter++) {
+        const double to_leave = m_eps * std::abs(x.x) + m_eps / 10;
+        if (std::abs(x.x - bnds.middle()) <= 2 * to_leave - bnds.length() / 2) {
+            break;
+        }
+
+        next_step(bnds, x, w, v, to_leave, step, prev_step);
+
+        Probe u;
+        if (std::abs(step) >= to_leave) {
+            u = probe(fn, x.x + step);
+        } else {
+            u = probe(fn, x.x + directed(to_leave, step));
+            if (u.f > x.f) {
+                /*
+                 * Minimal step does not decrease the function, so we are close enough.
+                 */
+                break;
+            }
+        }
+        update(bnds, x, w, v, u);
+    }
+
+    return {x.x, x.f};
+}
+
+TracedSearchRes BrentDeriv::find_min_tracked_impl() noexcept /*override*/
+{
+    using namespace util;
+
+    const auto & fn = last_func();
+    assert(fn.has_derivative() && "BrentDeriv requires function with derivative");
+    auto bnds = fn.bounds();
+    uint iter_num = 0;
+
+    Probe x = probe(fn, bnds.from + TAU * bnds.length());
+    Probe w = x, v = x;
+    double step = 0., prev_step = 0.;
+    for (; !budget_exhausted(iter_num); iter_num++) {
+        m_replay_data.emplace_back<VdSegment>(iter_num, bnds.from, bnds.to);
+        m_replay_data.emplace_back<VdComment>(iter_num, "Points x, w, v and derivative in x are:");
+        m_replay_data.emplace_back<VdPoint>(iter_num, x.x, x.f);
+        m_replay_data.emplace_back<VdPoint>(iter_num, w.x, w.f);
+        m_replay_data.emplace_back<VdPoint>(iter_num, v.x, v.f);
+        m_replay_data.emplace_back<VdDouble>(iter_num, x.df);
+
+        const double to_leave = m_eps * std::abs(x.x) + m_eps / 10;
+        if (std::abs(x.x - bnds.middle()) <= 2 * to_leave - bnds.length() / 2) {
+            break;
+        }
+
+        const bool is_secant = next_step(bnds, x, w, v, to_leave, step, prev_step);
+        m_replay_data.emplace_back<VdComment>(iter_num, is_secant ? "Accept secant step." : "Do not accept secant step. Use bisection.");
+
+        Probe u;
+        if (std::abs(step) >= to_leave) {
+            u = probe(fn, x.x + step);
+        } else {
+            u = probe(fn, x.x + directed(to_leave, step));
+            if (u.f > x.f) {
+                m_replay_data.emplace_back<VdComment>(iter_num, "Minimal step does not decrease the function.");
+                break;
+            }
+        }
+        m_replay_data.emplace_back<VdComment>(iter_num, "Point u is:");
+        m_replay_data.emplace_back<VdPoint>(iter_num, u.x, u.f);
+
+        update(bnds, x, w, v, u);
+    }
+
+    m_replay_data.emplace_back<VdComment>(iter_num, "Answer is");
+    m_replay_data.emplace_back<VdPoint>(iter_num, x.x, x.f);
+    return {{x.x, x.f}, m_replay_data};
+}
+
+} // namespace min1d
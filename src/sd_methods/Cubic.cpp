@@ -0,0 +1,171 @@
+#include "sd_methods/Cubic.h"
+
+#include "sd_methods/MinSearcher.h"
+
+#include "util/ReplayData.h"
+#include "util/VersionedData.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace min1d {
+/*
+ * Helper functions for cubic interpolation method.
+ */
+namespace {
+
+struct Probe
+{
+    double x, f, df;
+};
+
+Probe probe(const util::Function & fn, double x)
+{
+    return {x, fn(x), fn.derivative(x)};
+}
+
+/*
+ * Minimum of the cubic polynomial, which has the same values and derivatives as the function in points a and b.
+ * Safeguard: if there is no such minimum inside of the segment, or the segment did not shrink
+ * enough on the previous iteration, the middle of the segment is returned instead.
+ * Minimum too close to the segment's ends is moved inside by half of epsilon,
+ * so that the next segment is either short enough or shrinks noticeably.
+ */
+double count_cubic(const Probe & a, const Probe & b, double eps, bool stalled, bool & is_accepted)
+{
+    const double len = b.x - a.x;
+    const double d1 = a.df + b.df - 3 * (a.f - b.f) / (a.x - b.x);
+    const double disc = d1 * d1 - a.df * b.df;
+
+    is_accepted = false;
+    if (stalled || disc < 0) {
+        return a.x + len / 2;
+    }
+    const double d2 = std::sqrt(disc);
+    const double u = b.x - len * (b.df + d2 - d1) / (b.df - a.df + 2 * d2);
+
+    if (!(a.x < u && u < b.x)) { // also catches NaN
+        return a.x + len / 2;
+    }
+    is_accepted = true;
+    return std::clamp(u, a.x + eps / 2, b.x - eps / 2);
+}
+
+} // anonymous namespace
+
+SearchRes Cubic::find_min_impl() noexcept /*override*/
+{
+    const auto & fn = last_func();
+    assert(fn.has_derivative() && "Cubic requires function with derivative");
+    auto bnds = fn.bounds();
+
+    /*
+     * Keep segment [a, b], so that f'(a) < 0 < f'(b): minimum of a unimodal function lies inside of it.
+     * If it is not true for the initial segment, the minimum is in one of its ends.
+     * On each iteration construct the cubic polynomial by values and derivatives in a and b and find its minimum u.
+     * Replace a or b with u according to the sign of f'(u).
+     * If the segment does not shrink at least by half, bisect it on the next iteration.
+     * Break, when the segment's length is less than epsilon (epsilon is required accuracy).
+     */
+    Probe a = probe(fn, bnds.from);
+    Probe b = probe(fn, bnds.to);
+    if (a.df >= 0) {
+        return {a.x, a.f};
+    }
+    if (b.df <= 0) {
+        return {b.x, b.f};
+    }
+
+    Probe best = a.f < b.f ? a : b;
+    double prev_len = b.x - a.x;
+    bool stalled = false;
+    for (uint iter = 0; b.x - a.x > m_eps && !budget_exhausted(iter); iter++) {
+        bool is_accepted;
+        const Probe u = probe(fn, count_cubic(a, b, m_eps, stalled, is_accepted));
+        if (u.f <= best.f) {
+            best = u;
+        }
+        if (u.df == 0) {
+            break;
+        }
+
+        if (u.df > 0) {
+            /*
+             * Minimum is to the left from u.
+             * Proceed with [a, u].
+             */
+            b = u;
+        } else { // u.df < 0
+            /*
+             * Minimum is to the right from u.
+             * Proceed with [u, b].
+             */
+            a = u;
+        }
+
+        const double len = b.x - a.x;
+        stalled = len > prev_len / 2;
+        prev_len = len;
+    }
+
+    return {best.x, best.f};
+}
+
+TracedSearchRes Cubic::find_min_tracked_impl() noexcept /*override*/
+{
+    using namespace util;
+
+    const auto & fn = last_func();
+    assert(fn.has_derivative() && "Cubic requires function with derivative");
+    auto bnds = fn.bounds();
+    uint iter_num = 0;
+
+    Probe a = probe(fn, bnds.from);
+    Probe b = probe(fn, bnds.to);
+    if (a.df >= 0 || b.df <= 0) {
+        const Probe & end = a.df >= 0 ? a : b;
+        m_replay_data.emplace_back<VdComment>(iter_num, "Function is monotonic on the segment. Answer is");
+        m_replay_data.emplace_back<VdPoint>(iter_num, end.x, end.f);
+        return {{end.x, end.f}, m_replay_data};
+    }
+
+    Probe best = a.f < b.f ? a : b;
+    double prev_len = b.x - a.x;
+    bool stalled = false;
+    for (; b.x - a.x > m_eps && !budget_exhausted(iter_num); iter_num++) {
+        m_replay_data.emplace_back<VdSegment>(iter_num, a.x, b.x);
+        m_replay_data.emplace_back<VdComment>(iter_num, "Derivatives in a and b are:");
+        m_replay_data.emplace_back<VdDouble>(iter_num, a.df);
+        m_replay_data.emplace_back<VdDouble>(iter_num, b.df);
+
+        bool is_accepted;
+        const Probe u = probe(fn, count_cubic(a, b, m_eps, stalled, is_accepted));
+        m_replay_data.emplace_back<VdComment>(iter_num, is_accepted ? "Accept cubic minimum." : "Do not accept cubic minimum. Use bisection.");
+        m_replay_data.emplace_back<VdPoint>(iter_num, u.x, u.f);
+
+        if (u.f <= best.f) {
+            best = u;
+        }
+        if (u.df == 0) {
+            break;
+        }
+        if (u.df > 0) {
+            b = u;
+            m_replay_data.emplace_back<VdComment>(iter_num, "Chose segment [a, u]");
+        } else {
+            a = u;
+            m_replay_data.emplace_back<VdComment>(iter_num, "Chose segment [u, b]");
+        }
+
+        const double len = b.x - a.x;
+        stalled = len > prev_len / 2;
+        prev_len = len;
+    }
+
+    m_replay_data.emplace_back<VdComment>(iter_num, "Answer is");
+    m_replay_data.emplace_back<VdPoint>(iter_num, best.x, best.f);
+    return {{best.x, best.f}, m_replay_data};
+}
+
+} // namespace min1d
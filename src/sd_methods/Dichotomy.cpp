@@ -19,7 +19,8 @@ SearchRes Dichotomy::find_min_impl() noexcept /*override*/
      * Break, when the segment's length is less than epsilon (epsilon is required accuracy).
      */
     double mid;
-    for (mid = bnds.middle(); bnds.length() > m_eps; mid = bnds.middle()) {
+    uint iter = 0;
+    for (mid = bnds.middle(); bnds.length() > m_eps && !budget_exhausted(iter); mid = bnds.middle(), iter++) {
         double x_left = mid - m_sigma;
         double f_left = fn(x_left);
         double x_right = mid + m_sigma;
@@ -51,7 +52,7 @@ TracedSearchRes Dichotomy::find_min_tracked_impl() noexcept /*override*/
     uint iter_num = 0;
 
     double left, right, f_left, f_right, mid;
-    for (mid = bnds.middle(); bnds.length() > m_eps; mid = bnds.middle()) {
+    for (mid = bnds.middle(); bnds.length() > m_eps && !budget_exhausted(iter_num); mid = bnds.middle()) {
         left = mid - m_sigma;
         right = mid + m_sigma;
         f_left = fn(left);
@@ -73,7 +74,7 @@ TracedSearchRes Dichotomy::find_min_tracked_impl() noexcept /*override*/
     }
     m_replay_data.emplace_back<VdPoint>(iter_num, mid, fn(mid));
 
-    return {mid, fn(mid), m_replay_data};
+    return {{mid, fn(mid)}, m_replay_data};
 }
 
 } // namespace min1d
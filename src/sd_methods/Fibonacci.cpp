@@ -40,7 +40,7 @@ SearchRes Fibonacci::find_min_impl() noexcept /*override*/
     double f_left = fn(x_left);
     double f_right = fn(x_right);
 
-    for (int k = 1; k < n - 2; k++) {
+    for (int k = 1; k < n - 2 && !budget_exhausted(k - 1); k++) {
         if (f_left > f_right) {
             /*
              * Minimum is in the right part
@@ -97,7 +97,7 @@ TracedSearchRes Fibonacci::find_min_tracked_impl() noexcept /*override*/
     double f_left = fn(x_left);
     double f_right = fn(x_right);
 
-    for (int k = 1; k < n - 2; k++) {
+    for (int k = 1; k < n - 2 && !budget_exhausted(k - 1); k++) {
         m_replay_data.emplace_back<VdSegment>(k, bnds.from, bnds.to);
         m_replay_data.emplace_back<VdPoint>(k, x_left, f_left);
         m_replay_data.emplace_back<VdPoint>(k, x_right, f_right);
@@ -125,7 +125,7 @@ TracedSearchRes Fibonacci::find_min_tracked_impl() noexcept /*override*/
     double mid = bnds.middle();
     m_replay_data.emplace_back<VdSegment>(n - 2, bnds.from, bnds.to);
     m_replay_data.emplace_back<VdPoint>(n - 2, mid, fn(mid));
-    return {mid, fn(mid), m_replay_data};
+    return {{mid, fn(mid)}, m_replay_data};
 }
 
 } // namespace min1d
@@ -23,7 +23,7 @@ SearchRes Golden::find_min_impl() noexcept /*override*/
     double x_right = bnds.from + TAU * bnds.length();
     double f_right = fn(x_right);
 
-    while (bnds.length() > m_eps) {
+    for (uint iter = 0; bnds.length() > m_eps && !budget_exhausted(iter); iter++) {
         if (f_left > f_right) {
             /*
              * Minimum is in the right part
@@ -68,7 +68,7 @@ TracedSearchRes Golden::find_min_tracked_impl() noexcept /*override*/
     double x_right = bnds.from + TAU * bnds.length();
     double f_right = fn(x_right);
 
-    while (bnds.length() > m_eps) {
+    while (bnds.length() > m_eps && !budget_exhausted(iter_num)) {
         m_replay_data.emplace_back<VdSegment>(iter_num, bnds.from, bnds.to);
         m_replay_data.emplace_back<VdPoint>(iter_num, x_left, f_left);
         m_replay_data.emplace_back<VdPoint>(iter_num, x_right, f_right);
@@ -97,7 +97,67 @@ TracedSearchRes Golden::find_min_tracked_impl() noexcept /*override*/
     double mid = bnds.middle();
     m_replay_data.emplace_back<VdSegment>(iter_num, bnds.from, bnds.to);
     m_replay_data.emplace_back<VdPoint>(iter_num, mid, fn(mid));
-    return {mid, fn(mid), m_replay_data};
+    return {{mid, fn(mid)}, m_replay_data};
+}
+
+GoldenStepper::GoldenStepper(util::Function::Bounds bounds, double eps, util::SolveBudget budget)
+    : Stepper(std::move(budget))
+    , m_bnds(bounds)
+    , m_eps(eps)
+    , m_x_left(bounds.to - Golden::TAU * bounds.length())
+    , m_x_right(bounds.from + Golden::TAU * bounds.length())
+{
+    m_points = {m_x_left, m_x_right};
+}
+
+void GoldenStepper::tell(const std::vector<double> & values)
+{
+    accept(values);
+    switch (m_state) {
+    case State::Start:
+        m_f_left = values[0];
+        m_f_right = values[1];
+        break;
+    case State::NewLeft:
+        m_f_left = values[0];
+        m_iter++;
+        break;
+    case State::NewRight:
+        m_f_right = values[0];
+        m_iter++;
+        break;
+    case State::Answer:
+        finish(m_points[0], values[0]);
+        return;
+    }
+    next();
+}
+
+void GoldenStepper::next()
+{
+    if (!(m_bnds.length() > m_eps && !budget_exhausted())) {
+        m_state = State::Answer;
+        request(m_bnds.middle());
+        return;
+    }
+    /*
+     * The same steps as in Golden::find_min_impl, but the new point is requested instead of calculated.
+     */
+    if (m_f_left > m_f_right) {
+        m_bnds.from = m_x_left;
+        m_x_left = m_x_right;
+        m_f_left = m_f_right;
+        m_x_right = m_bnds.from + Golden::TAU * m_bnds.length();
+        m_state = State::NewRight;
+        request(m_x_right);
+    } else {
+        m_bnds.to = m_x_right;
+        m_x_right = m_x_left;
+        m_f_right = m_f_left;
+        m_x_left = m_bnds.to - Golden::TAU * m_bnds.length();
+        m_state = State::NewLeft;
+        request(m_x_left);
+    }
 }
 
 } // namespace min1d
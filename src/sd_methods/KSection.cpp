@@ -0,0 +1,91 @@
+#include "sd_methods/KSection.h"
+
+#include "sd_methods/MinSearcher.h"
+
+#include "util/ReplayData.h"
+#include "util/VersionedData.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace min1d {
+
+namespace {
+
+/*
+ * Place k points evenly inside of the segment, so it is split into k + 1 equal parts.
+ */
+void place_points(util::Function::Bounds bnds, std::vector<double> & xs)
+{
+    const double step = bnds.length() / (xs.size() + 1);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = bnds.from + (i + 1) * step;
+    }
+}
+
+/*
+ * Segment around j-th point: from its left neighbour to its right neighbour.
+ */
+util::Function::Bounds choose_segment(util::Function::Bounds bnds, const std::vector<double> & xs, std::size_t j)
+{
+    return {j == 0 ? bnds.from : xs[j - 1], j + 1 == xs.size() ? bnds.to : xs[j + 1]};
+}
+
+} // anonymous namespace
+
+SearchRes KSection::find_min_impl() noexcept /*override*/
+{
+    const auto & fn = last_func();
+    auto bnds = fn.bounds();
+
+    /*
+     * On each iteration split the segment into k + 1 equal parts and calculate function in k inner points at once.
+     * Point with the least value is x_j, so the minimum lies in [x_{j-1}, x_{j+1}].
+     * The segment shrinks by (k + 1) / 2 per iteration.
+     * Break, when the segment's length is less than epsilon (epsilon is required accuracy).
+     */
+    std::vector<double> xs(m_points), ys(m_points);
+    for (uint iter = 0; bnds.length() > m_eps && !budget_exhausted(iter); iter++) {
+        place_points(bnds, xs);
+        fn(xs, ys, *m_pool);
+
+        const std::size_t j = std::min_element(ys.begin(), ys.end()) - ys.begin();
+        bnds = choose_segment(bnds, xs, j);
+    }
+
+    double mid = bnds.middle();
+    return {mid, fn(mid)};
+}
+
+TracedSearchRes KSection::find_min_tracked_impl() noexcept /*override*/
+{
+    using namespace util;
+
+    const auto & fn = last_func();
+    auto bnds = fn.bounds();
+    uint iter_num = 0;
+
+    std::vector<double> xs(m_points), ys(m_points);
+    while (bnds.length() > m_eps && !budget_exhausted(iter_num)) {
+        place_points(bnds, xs);
+        fn(xs, ys, *m_pool);
+
+        m_replay_data.emplace_back<VdSegment>(iter_num, bnds.from, bnds.to);
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            m_replay_data.emplace_back<VdPoint>(iter_num, xs[i], ys[i]);
+        }
+
+        const std::size_t j = std::min_element(ys.begin(), ys.end()) - ys.begin();
+        bnds = choose_segment(bnds, xs, j);
+        m_replay_data.emplace_back<VdComment>(iter_num, "Chose segment around point " + std::to_string(j + 1));
+
+        iter_num++;
+    }
+
+    double mid = bnds.middle();
+    m_replay_data.emplace_back<VdSegment>(iter_num, bnds.from, bnds.to);
+    m_replay_data.emplace_back<VdPoint>(iter_num, mid, fn(mid));
+    return {{mid, fn(mid)}, m_replay_data};
+}
+
+} // namespace min1d
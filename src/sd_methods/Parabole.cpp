@@ -25,7 +25,6 @@ SearchRes Parabole::find_min_impl() noexcept /*override*/
 {
     const auto & fn = last_func();
     auto bnds = fn.bounds();
-    const uint ITER_MAX = 100;
 
     /*
      * Start with finding three points x1 < x2 < x3, so that f(x1) >= f(x2) and f(x2) <= f(x3)
@@ -53,7 +52,7 @@ SearchRes Parabole::find_min_impl() noexcept /*override*/
 
     double prev_x, prev_f;
     bool is_first_iteration = true;
-    for (uint iter = 0; iter < ITER_MAX; iter++) {
+    for (uint iter = 0; !budget_exhausted(iter); iter++) {
         double new_x = count_parabole({x1, f1}, {x2, f2}, {x3, f3});
         if (!is_first_iteration && std::abs(new_x - prev_x) <= m_eps) {
             prev_x = new_x;
@@ -124,7 +123,6 @@ TracedSearchRes Parabole::find_min_tracked_impl() noexcept /*override*/
 
     const auto & fn = last_func();
     auto bnds = fn.bounds();
-    const uint ITER_MAX = 100;
     uint iter_num = 0;
 
     double x1 = bnds.from;
@@ -140,7 +138,7 @@ TracedSearchRes Parabole::find_min_tracked_impl() noexcept /*override*/
     double f2 = fn(x2);
 
     double prev_x, prev_f;
-    for (; iter_num < ITER_MAX; iter_num++) {
+    for (; !budget_exhausted(iter_num); iter_num++) {
         m_replay_data.emplace_back<VdComment>(iter_num, "Points x1, x2, x3 are:");
         m_replay_data.emplace_back<VdPoint>(iter_num, x1, f1);
         m_replay_data.emplace_back<VdPoint>(iter_num, x2, f2);
@@ -189,7 +187,7 @@ TracedSearchRes Parabole::find_min_tracked_impl() noexcept /*override*/
 
     m_replay_data.emplace_back<VdComment>(iter_num, "Answer is");
     m_replay_data.emplace_back<VdPoint>(iter_num, prev_x, fn(prev_x));
-    return {prev_x, prev_f, m_replay_data};
+    return {{prev_x, prev_f}, m_replay_data};
 }
 
 } // namespace min1d
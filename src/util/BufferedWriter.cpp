@@ -0,0 +1,44 @@
+#include "util/BufferedWriter.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace util {
+
+BufferedWriter::BufferedWriter(int fd, std::size_t capacity)
+    : m_fd(fd)
+    , m_capacity(capacity)
+{
+    m_buffer.reserve(capacity);
+}
+
+void BufferedWriter::write(std::string_view data)
+{
+    if (m_buffer.size() + data.size() > m_capacity) {
+        flush();
+    }
+    m_buffer += data;
+}
+
+MaybeErrorText BufferedWriter::flush()
+{
+    const char * pos = m_buffer.data();
+    std::size_t left = m_buffer.size();
+    while (left > 0 && !m_error) {
+        const ssize_t written = ::write(m_fd, pos, left);
+        if (written < 0) {
+            if (errno != EINTR) {
+                m_error = std::string("write failed: ") + std::strerror(errno);
+            }
+            continue;
+        }
+        pos += written;
+        left -= written;
+    }
+    m_buffer.clear();
+    return m_error;
+}
+
+} // namespace util
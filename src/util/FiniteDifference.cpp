@@ -0,0 +1,73 @@
+#include "util/FiniteDifference.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace util {
+
+namespace {
+
+constexpr std::size_t CHUNKS_PER_THREAD = 4; // more chunks than threads, so that slow evaluations are balanced
+
+} // anonymous namespace
+
+FiniteDifference::FiniteDifference(std::size_t dims, CalculateNFunc calculate, DifferenceScheme scheme, ThreadPool * pool)
+    : m_dims(dims)
+    , m_calculate(std::move(calculate))
+    , m_scheme(scheme)
+    , m_pool(pool)
+    , m_rel_step(scheme == DifferenceScheme::Central ? std::cbrt(std::numeric_limits<double>::epsilon())
+                                                     : std::sqrt(std::numeric_limits<double>::epsilon()))
+{}
+
+double FiniteDifference::operator()(const Vector & x) const
+{
+    assert(x.dims() == m_dims && "FiniteDifference dim mismatch");
+    return m_calculate(std::vector<double>(x.data(), x.data() + x.dims()));
+}
+
+Vector FiniteDifference::grad(const Vector & x) const
+{
+    return grad(x, m_scheme == DifferenceScheme::Forward ? (*this)(x) : 0.);
+}
+
+Vector FiniteDifference::grad(const Vector & x, double f_x) const
+{
+    assert(x.dims() == m_dims && "FiniteDifference dim mismatch");
+    std::vector<double> res(m_dims);
+    const std::size_t threads = m_pool ? m_pool->size() + 1 : 1;
+    const std::size_t chunks = std::min(m_dims, threads == 1 ? 1 : threads * CHUNKS_PER_THREAD);
+    auto run = [&](std::size_t chunk) {
+        std::vector<double> scratch(x.data(), x.data() + x.dims());
+        grad_range(x, f_x, chunk * m_dims / chunks, (chunk + 1) * m_dims / chunks, scratch, res.data());
+    };
+    if (m_pool && chunks > 1) {
+        m_pool->parallel_for(chunks, run);
+    } else if (chunks > 0) {
+        run(0);
+    }
+    return Vector(std::move(res));
+}
+
+void FiniteDifference::grad_range(const Vector & x, double f_x, std::size_t from, std::size_t to, std::vector<double> & scratch, double * grad) const
+{
+    for (std::size_t j = from; j < to; ++j) {
+        const double x_j = x[j];
+        const double h = m_rel_step * std::max(std::abs(x_j), 1.);
+        const double forward = x_j + h;
+        scratch[j] = forward;
+        const double f_forward = m_calculate(scratch);
+        if (m_scheme == DifferenceScheme::Central) {
+            const double backward = x_j - h;
+            scratch[j] = backward;
+            grad[j] = (f_forward - m_calculate(scratch)) / (forward - backward);
+        } else {
+            grad[j] = (f_forward - f_x) / (forward - x_j);
+        }
+        scratch[j] = x_j;
+    }
+}
+
+} // namespace util
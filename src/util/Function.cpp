@@ -1,5 +1,7 @@
 #include "util/Function.h"
 
+#include "util/ThreadPool.h"
+
 #include <iostream>
 
 namespace util {
@@ -14,12 +16,58 @@ Function::Function(CalculateFunc calculate, Bounds bounds)
     : Function("none", std::move(calculate), bounds)
 {}
 
+Function::Function(std::string as_string, CalculateFunc calculate, CalculateFunc derivative, Bounds bounds)
+    : m_as_string(std::move(as_string))
+    , m_calculate(std::move(calculate))
+    , m_derivative(std::move(derivative))
+    , m_bounds(bounds)
+{}
+
+Function::Function(CalculateFunc calculate, CalculateFunc derivative, Bounds bounds)
+    : Function("none", std::move(calculate), std::move(derivative), bounds)
+{}
+
 void Function::reset(std::string as_string, CalculateFunc calculate)
 {
     m_as_string = std::move(as_string);
     m_calculate = std::move(calculate);
+    m_derivative = nullptr; // derivative of the previous function is not valid anymore
+    if (m_cache) {
+        m_cache->clear();
+    }
 }
 
+void Function::operator()(const std::vector<double> & xs, std::vector<double> & ys, ThreadPool & pool) const
+{
+    ys.resize(xs.size());
+    if (!m_cache) {
+        /*
+         * Count calls here, so that the counter is not touched from several threads.
+         */
+        m_call_count += xs.size();
+        pool.parallel_for(xs.size(), [&](std::size_t i) { ys[i] = m_calculate(xs[i]); });
+        return;
+    }
+
+    /*
+     * Look up the cache from this thread, calculate only missed points concurrently.
+     */
+    std::vector<std::size_t> missed;
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        if (auto cached = m_cache->find(xs[i])) {
+            ys[i] = *cached;
+            ++m_cache_hits;
+        } else {
+            missed.push_back(i);
+        }
+    }
+    m_cache_misses += missed.size();
+    m_call_count += missed.size();
+    pool.parallel_for(missed.size(), [&](std::size_t i) { ys[missed[i]] = m_calculate(xs[missed[i]]); });
+    for (auto i : missed) {
+        m_cache->insert(xs[i], ys[i]);
+    }
+}
 
 std::ostream & operator<<(std::ostream & out, const Function & func)
 {
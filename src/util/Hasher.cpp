@@ -0,0 +1,82 @@
+#include "util/Hasher.h"
+
+#include <cstring>
+
+namespace util {
+
+namespace {
+
+constexpr std::uint64_t P1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t P3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+
+inline std::uint64_t rotl(std::uint64_t x, int r) noexcept
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline std::uint64_t read64(const unsigned char * ptr) noexcept
+{
+    std::uint64_t res;
+    std::memcpy(&res, ptr, sizeof(res));
+    return res;
+}
+
+inline std::uint64_t round(std::uint64_t acc, std::uint64_t input) noexcept
+{
+    return rotl(acc + input * P2, 31) * P1;
+}
+
+inline std::uint64_t avalanche(std::uint64_t x) noexcept
+{
+    x ^= x >> 33;
+    x *= P2;
+    x ^= x >> 29;
+    x *= P3;
+    x ^= x >> 32;
+    return x;
+}
+
+} // anonymous namespace
+
+Hasher & Hasher::add(const void * data, std::size_t size) noexcept
+{
+    const auto * ptr = static_cast<const unsigned char *>(data);
+    const auto * const end = ptr + size;
+
+    std::uint64_t h;
+    if (size >= 32) {
+        std::uint64_t v1 = m_state + P1 + P2, v2 = m_state + P2, v3 = m_state, v4 = m_state - P1;
+        for (; end - ptr >= 32; ptr += 32) {
+            v1 = round(v1, read64(ptr));
+            v2 = round(v2, read64(ptr + 8));
+            v3 = round(v3, read64(ptr + 16));
+            v4 = round(v4, read64(ptr + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        for (const auto v : {v1, v2, v3, v4}) {
+            h = (h ^ round(0, v)) * P1 + P4;
+        }
+    } else {
+        h = m_state + P4;
+    }
+
+    h += size;
+    for (; end - ptr >= 8; ptr += 8) {
+        h = rotl(h ^ round(0, read64(ptr)), 27) * P1 + P4;
+    }
+    for (; ptr < end; ++ptr) {
+        h = rotl(h ^ (*ptr * P4), 11) * P1;
+    }
+
+    m_state = avalanche(h);
+    return *this;
+}
+
+std::uint64_t Hasher::digest() const noexcept
+{
+    return avalanche(m_state ^ P3);
+}
+
+} // namespace util
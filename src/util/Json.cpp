@@ -0,0 +1,350 @@
+#include "util/Json.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace util {
+
+namespace {
+
+/*
+ * Recursive descent parser over the text.
+ */
+struct JsonParser
+{
+    static constexpr uint MAX_DEPTH = 64;
+
+    explicit JsonParser(std::string_view text)
+        : m_text(text)
+    {}
+
+    ErrorOr<JsonValue> parse_document()
+    {
+        JsonValue res;
+        if (!parse_value(res, 0)) {
+            return std::move(m_error);
+        }
+        skip_spaces();
+        if (m_pos != m_text.size()) {
+            fail("unexpected trailing characters");
+            return std::move(m_error);
+        }
+        return res;
+    }
+
+private:
+    bool parse_value(JsonValue & res, uint depth)
+    {
+        if (depth > MAX_DEPTH) {
+            return fail("nesting is too deep");
+        }
+        skip_spaces();
+        if (m_pos == m_text.size()) {
+            return fail("unexpected end of input");
+        }
+        switch (m_text[m_pos]) {
+        case '{': return parse_object(res, depth);
+        case '[': return parse_array(res, depth);
+        case '"': {
+            std::string str;
+            if (!parse_string(str)) {
+                return false;
+            }
+            res = JsonValue(std::move(str));
+            return true;
+        }
+        case 't': return parse_literal("true", JsonValue(true), res);
+        case 'f': return parse_literal("false", JsonValue(false), res);
+        case 'n': return parse_literal("null", JsonValue(nullptr), res);
+        default: return parse_number(res);
+        }
+    }
+
+    bool parse_object(JsonValue & res, uint depth)
+    {
+        JsonObject obj;
+        ++m_pos; // '{'
+        skip_spaces();
+        if (consume('}')) {
+            res = JsonValue(std::move(obj));
+            return true;
+        }
+        do {
+            skip_spaces();
+            std::string key;
+            if (m_pos == m_text.size() || m_text[m_pos] != '"' || !parse_string(key)) {
+                return m_error.empty() ? fail("expected member name") : false;
+            }
+            skip_spaces();
+            if (!consume(':')) {
+                return fail("expected ':'");
+            }
+            JsonValue member;
+            if (!parse_value(member, depth + 1)) {
+                return false;
+            }
+            obj.emplace_back(std::move(key), std::move(member));
+            skip_spaces();
+        } while (consume(','));
+        if (!consume('}')) {
+            return fail("expected ',' or '}'");
+        }
+        res = JsonValue(std::move(obj));
+        return true;
+    }
+
+    bool parse_array(JsonValue & res, uint depth)
+    {
+        JsonArray arr;
+        ++m_pos; // '['
+        skip_spaces();
+        if (consume(']')) {
+            res = JsonValue(std::move(arr));
+            return true;
+        }
+        do {
+            arr.emplace_back();
+            if (!parse_value(arr.back(), depth + 1)) {
+                return false;
+            }
+            skip_spaces();
+        } while (consume(','));
+        if (!consume(']')) {
+            return fail("expected ',' or ']'");
+        }
+        res = JsonValue(std::move(arr));
+        return true;
+    }
+
+    bool parse_string(std::string & res)
+    {
+        ++m_pos; // '"'
+        while (m_pos < m_text.size()) {
+            const char ch = m_text[m_pos++];
+            if (ch == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                return fail("control character in string");
+            }
+            if (ch != '\\') {
+                res += ch;
+                continue;
+            }
+            if (m_pos == m_text.size()) {
+                break;
+            }
+            switch (const char esc = m_text[m_pos++]) {
+            case '"':
+            case '\\':
+            case '/': res += esc; break;
+            case 'b': res += '\b'; break;
+            case 'f': res += '\f'; break;
+            case 'n': res += '\n'; break;
+            case 'r': res += '\r'; break;
+            case 't': res += '\t'; break;
+            case 'u':
+                if (!parse_unicode_escape(res)) {
+                    return false;
+                }
+                break;
+            default: return fail("bad escape sequence");
+            }
+        }
+        return fail("unterminated string");
+    }
+
+    /*
+     * \uXXXX escape (with a surrogate pair if needed), appended in UTF-8.
+     */
+    bool parse_unicode_escape(std::string & res)
+    {
+        unsigned long code;
+        if (!parse_hex4(code)) {
+            return false;
+        }
+        if (code >= 0xD800 && code < 0xDC00) {
+            unsigned long low;
+            if (!consume('\\') || !consume('u') || !parse_hex4(low) || low < 0xDC00 || low >= 0xE000) {
+                return fail("bad surrogate pair");
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (code < 0x80) {
+            res += static_cast<char>(code);
+        } else if (code < 0x800) {
+            res += static_cast<char>(0xC0 | (code >> 6));
+            res += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            res += static_cast<char>(0xE0 | (code >> 12));
+            res += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            res += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            res += static_cast<char>(0xF0 | (code >> 18));
+            res += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            res += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            res += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        return true;
+    }
+
+    bool parse_hex4(unsigned long & code)
+    {
+        if (m_text.size() - m_pos < 4) {
+            return fail("bad unicode escape");
+        }
+        const std::string hex(m_text.substr(m_pos, 4));
+        char * end = nullptr;
+        code = std::strtoul(hex.c_str(), &end, 16);
+        if (end != hex.c_str() + 4) {
+            return fail("bad unicode escape");
+        }
+        m_pos += 4;
+        return true;
+    }
+
+    bool parse_number(JsonValue & res)
+    {
+        const std::size_t from = m_pos;
+        while (m_pos < m_text.size() && std::string_view("+-0123456789.eE").find(m_text[m_pos]) != std::string_view::npos) {
+            ++m_pos;
+        }
+        if (from == m_pos) {
+            return fail("unexpected character");
+        }
+        const std::string num(m_text.substr(from, m_pos - from));
+        char * end = nullptr;
+        const double value = std::strtod(num.c_str(), &end);
+        if (end != num.c_str() + num.size()) {
+            return fail("bad number");
+        }
+        res = JsonValue(value);
+        return true;
+    }
+
+    bool parse_literal(std::string_view literal, JsonValue value, JsonValue & res)
+    {
+        if (m_text.substr(m_pos, literal.size()) != literal) {
+            return fail("unexpected character");
+        }
+        m_pos += literal.size();
+        res = std::move(value);
+        return true;
+    }
+
+    void skip_spaces() noexcept
+    {
+        while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+            ++m_pos;
+        }
+    }
+
+    bool consume(char ch) noexcept
+    {
+        if (m_pos < m_text.size() && m_text[m_pos] == ch) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool fail(const char * what)
+    {
+        m_error = std::string(what) + " at offset " + std::to_string(m_pos);
+        return false;
+    }
+
+private:
+    std::string_view m_text;
+    std::size_t m_pos = 0;
+    std::string m_error;
+};
+
+} // anonymous namespace
+
+const JsonValue * JsonValue::find(std::string_view key) const noexcept
+{
+    if (auto obj = get_if<JsonObject>()) {
+        for (const auto & [name, member] : *obj) {
+            if (name == key) {
+                return &member;
+            }
+        }
+    }
+    return nullptr;
+}
+
+ErrorOr<JsonValue> parse_json(std::string_view text)
+{
+    return JsonParser(text).parse_document();
+}
+
+void write_json(std::string & out, std::string_view str)
+{
+    static constexpr char HEX[] = "0123456789abcdef";
+    out += '"';
+    for (const char ch : str) {
+        switch (ch) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                out += "\\u00";
+                out += HEX[ch >> 4];
+                out += HEX[ch & 0xF];
+            } else {
+                out += ch;
+            }
+        }
+    }
+    out += '"';
+}
+
+void write_json(std::string & out, double number)
+{
+    if (!std::isfinite(number)) {
+        out += "null"; // JSON has no infinities and NaNs
+        return;
+    }
+    char buf[32];
+    const int len = std::snprintf(buf, sizeof(buf), "%.17g", number);
+    out.append(buf, len);
+}
+
+void write_json(std::string & out, const JsonValue & value)
+{
+    std::visit(util::overload(
+                       [&](std::nullptr_t) { out += "null"; },
+                       [&](bool flag) { out += flag ? "true" : "false"; },
+                       [&](double number) { write_json(out, number); },
+                       [&](const std::string & str) { write_json(out, std::string_view(str)); },
+                       [&](const JsonArray & arr) {
+                           out += '[';
+                           for (std::size_t i = 0; i < arr.size(); ++i) {
+                               if (i > 0) {
+                                   out += ',';
+                               }
+                               write_json(out, arr[i]);
+                           }
+                           out += ']';
+                       },
+                       [&](const JsonObject & obj) {
+                           out += '{';
+                           for (std::size_t i = 0; i < obj.size(); ++i) {
+                               if (i > 0) {
+                                   out += ',';
+                               }
+                               write_json(out, std::string_view(obj[i].first));
+                               out += ':';
+                               write_json(out, obj[i].second);
+                           }
+                           out += '}';
+                       }),
+               value.value());
+}
+
+} // namespace util
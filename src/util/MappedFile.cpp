@@ -0,0 +1,85 @@
+#include "util/MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace util {
+
+namespace {
+
+std::string error_text(const std::string & what, const std::string & path)
+{
+    return what + " '" + path + "': " + std::strerror(errno);
+}
+
+} // anonymous namespace
+
+/*static*/ ErrorOr<std::shared_ptr<MappedFile>> MappedFile::open(const std::string & path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return error_text("cannot open", path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        auto err = error_text("cannot stat", path);
+        close(fd);
+        return err;
+    }
+    const std::size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return "file '" + path + "' is empty";
+    }
+
+    void * data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        auto err = error_text("cannot map", path);
+        close(fd);
+        return err;
+    }
+    close(fd); // mapping keeps the file alive
+    return std::shared_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+/*static*/ ErrorOr<std::shared_ptr<MappedFile>> MappedFile::create(const std::string & path, std::size_t size)
+{
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return error_text("cannot create", path);
+    }
+    if (ftruncate(fd, size) != 0) {
+        auto err = error_text("cannot resize", path);
+        close(fd);
+        return err;
+    }
+
+    void * data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        auto err = error_text("cannot map", path);
+        close(fd);
+        return err;
+    }
+    close(fd);
+    return std::shared_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+MappedFile::~MappedFile()
+{
+    munmap(m_data, m_size);
+}
+
+MaybeErrorText MappedFile::sync() const
+{
+    if (msync(m_data, m_size, MS_SYNC) != 0) {
+        return std::string("msync failed: ") + std::strerror(errno);
+    }
+    return std::nullopt;
+}
+
+} // namespace util
@@ -0,0 +1,224 @@
+#include "util/MatrixMarket.h"
+
+#include "util/ProblemFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace util {
+
+namespace {
+
+struct MmHeader
+{
+    bool is_coordinate;
+    std::size_t rows, cols, entries;
+};
+
+/*
+ * Reads Matrix Market file line by line.
+ */
+struct MmReader
+{
+    explicit MmReader(const std::string & path)
+        : m_in(path)
+        , m_path(path)
+    {}
+
+    MaybeErrorText read_header(MmHeader & hdr)
+    {
+        if (!m_in) {
+            return "cannot open '" + m_path + "'";
+        }
+        std::string line;
+        if (!std::getline(m_in, line)) {
+            return error("file is empty");
+        }
+        ++m_line_num;
+        std::transform(line.begin(), line.end(), line.begin(), [](unsigned char ch) { return std::tolower(ch); });
+
+        std::istringstream banner(line);
+        std::string tag, object, format, field, symmetry;
+        banner >> tag >> object >> format >> field >> symmetry;
+        if (tag != "%%matrixmarket" || object != "matrix") {
+            return error("no Matrix Market banner");
+        }
+        if (format != "coordinate" && format != "array") {
+            return error("unknown format '" + format + "'");
+        }
+        if (field != "real" && field != "integer" && field != "double") {
+            return error("field '" + field + "' is not supported");
+        }
+        hdr.is_coordinate = format == "coordinate";
+
+        if (!next_line(line)) {
+            return error("no size line");
+        }
+        std::istringstream sizes(line);
+        sizes >> hdr.rows >> hdr.cols;
+        if (hdr.is_coordinate) {
+            sizes >> hdr.entries;
+        } else {
+            hdr.entries = hdr.rows * hdr.cols;
+        }
+        if (!sizes) {
+            return error("bad size line");
+        }
+        return std::nullopt;
+    }
+
+    /*
+     * Read next line with data, skipping comments and empty lines.
+     */
+    bool next_line(std::string & line)
+    {
+        while (std::getline(m_in, line)) {
+            ++m_line_num;
+            const auto first = line.find_first_not_of(" \t\r");
+            if (first != std::string::npos && line[first] != '%') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Read entry "i j value" of coordinate format (indices are 1-based) or "value" of array format.
+     */
+    MaybeErrorText read_entry(bool is_coordinate, std::size_t & row, std::size_t & col, double & value)
+    {
+        if (!next_line(m_line)) {
+            return error("unexpected end of file");
+        }
+        const char * pos = m_line.c_str();
+        char * end = nullptr;
+        if (is_coordinate) {
+            row = std::strtoull(pos, &end, 10);
+            col = std::strtoull(pos = end, &end, 10);
+            if (end == pos || row == 0 || col == 0) {
+                return error("bad entry");
+            }
+            --row;
+            --col;
+            pos = end;
+        }
+        value = std::strtod(pos, &end);
+        if (end == pos) {
+            return error("bad value");
+        }
+        return std::nullopt;
+    }
+
+    std::string error(const std::string & what) const
+    {
+        return m_path + ":" + std::to_string(m_line_num) + ": " + what;
+    }
+
+private:
+    std::ifstream m_in;
+    std::string m_path;
+    std::string m_line;
+    std::size_t m_line_num = 0;
+};
+
+MaybeErrorText read_diagonal(MmReader & reader, const MmHeader & hdr, double * diag)
+{
+    if (!hdr.is_coordinate) {
+        return reader.error("matrix must be in coordinate format");
+    }
+    for (std::size_t k = 0; k < hdr.entries; ++k) {
+        std::size_t row, col;
+        double value;
+        if (auto err = reader.read_entry(true, row, col, value)) {
+            return err;
+        }
+        if (row >= hdr.rows || col >= hdr.cols) {
+            return reader.error("index out of range");
+        }
+        if (row != col) {
+            if (value != 0.) {
+                return reader.error("off-diagonal entries are not supported, only diagonal matrices are");
+            }
+            continue;
+        }
+        diag[row] += value; // duplicate entries are summed
+    }
+    return std::nullopt;
+}
+
+MaybeErrorText read_vector(MmReader & reader, const MmHeader & hdr, std::size_t dims, double * vec)
+{
+    if (hdr.rows != dims || hdr.cols != 1) {
+        return reader.error("b must be a " + std::to_string(dims) + " x 1 vector");
+    }
+    for (std::size_t k = 0; k < hdr.entries; ++k) {
+        std::size_t row = k, col = 0;
+        double value;
+        if (auto err = reader.read_entry(hdr.is_coordinate, row, col, value)) {
+            return err;
+        }
+        if (row >= dims || col != 0) {
+            return reader.error("index out of range");
+        }
+        vec[row] = value;
+    }
+    return std::nullopt;
+}
+
+MaybeErrorText convert(const std::string & a_path, const std::string & b_path, double c, const std::string & out_path)
+{
+    MmReader a_reader(a_path);
+    MmHeader a_hdr;
+    if (auto err = a_reader.read_header(a_hdr)) {
+        return err;
+    }
+    if (a_hdr.rows != a_hdr.cols) {
+        return a_reader.error("matrix is not square");
+    }
+
+    auto created = ProblemWriter::create(out_path, a_hdr.rows);
+    if (auto err = std::get_if<std::string>(&created)) {
+        return std::move(*err);
+    }
+    auto & writer = std::get<ProblemWriter>(created);
+
+    /*
+     * The file is created zero-filled, so missing entries of A and b are zeros.
+     */
+    if (auto err = read_diagonal(a_reader, a_hdr, writer.a())) {
+        return err;
+    }
+    if (!b_path.empty()) {
+        MmReader b_reader(b_path);
+        MmHeader b_hdr;
+        if (auto err = b_reader.read_header(b_hdr)) {
+            return err;
+        }
+        if (auto err = read_vector(b_reader, b_hdr, writer.dims(), writer.b())) {
+            return err;
+        }
+    }
+
+    const auto [min, max] = std::minmax_element(writer.a(), writer.a() + writer.dims());
+    if (*min <= 0.) {
+        return a_reader.error("matrix is not positive definite");
+    }
+    return writer.finish(c, *min, *max);
+}
+
+} // anonymous namespace
+
+MaybeErrorText import_matrix_market(const std::string & a_path, const std::string & b_path, double c, const std::string & out_path)
+{
+    auto err = convert(a_path, b_path, c, out_path);
+    if (err) {
+        std::remove(out_path.c_str()); // do not leave unfinished file
+    }
+    return err;
+}
+
+} // namespace util
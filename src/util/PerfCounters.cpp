@@ -0,0 +1,134 @@
+#include "util/PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace util {
+
+std::string_view phase_name(Phase phase) noexcept
+{
+    switch (phase) {
+    case Phase::MatVec: return "mat_vec";
+    case Phase::VectorOps: return "vector_ops";
+    case Phase::LineSearch: return "line_search";
+    case Phase::Trace: return "trace";
+    case Phase::Other: return "other";
+    }
+    return "unknown";
+}
+
+#ifdef __linux__
+namespace {
+
+int open_counter(std::uint64_t config, int group_fd)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1; // allowed without privileges with perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0 /*this thread*/, -1 /*any cpu*/, group_fd, 0));
+}
+
+} // anonymous namespace
+
+PerfCounters::PerfCounters()
+{
+    const int leader = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (leader < 0) {
+        return;
+    }
+    const int instructions = open_counter(PERF_COUNT_HW_INSTRUCTIONS, leader);
+    const int misses = instructions < 0 ? -1 : open_counter(PERF_COUNT_HW_CACHE_MISSES, leader);
+    if (misses < 0) {
+        if (instructions >= 0) {
+            close(instructions);
+        }
+        close(leader);
+        return;
+    }
+    m_group_fd = leader;
+    m_member_fds = {instructions, misses};
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int fd : m_member_fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    if (m_group_fd >= 0) {
+        close(m_group_fd);
+    }
+}
+
+auto PerfCounters::read() const noexcept -> Values
+{
+    Values res;
+    if (m_group_fd < 0) {
+        return res;
+    }
+    std::uint64_t buf[1 + 3]; // number of counters, then their values in order of opening
+    if (::read(m_group_fd, buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf)) && buf[0] == 3) {
+        res.cycles = buf[1];
+        res.instructions = buf[2];
+        res.llc_misses = buf[3];
+    }
+    return res;
+}
+#else
+PerfCounters::PerfCounters() = default;
+PerfCounters::~PerfCounters() = default;
+
+auto PerfCounters::read() const noexcept -> Values
+{
+    return {};
+}
+#endif
+
+PhaseProfiler::PhaseProfiler()
+    : m_since_values(m_counters.read())
+    , m_since_time(Clock::now())
+{
+    m_stats.hardware = m_counters.available();
+}
+
+void PhaseProfiler::enter(Phase phase) noexcept
+{
+    if (phase != m_active) {
+        close_active();
+        m_active = phase;
+    }
+}
+
+PhaseStats PhaseProfiler::finish() noexcept
+{
+    close_active();
+    return m_stats;
+}
+
+void PhaseProfiler::close_active() noexcept
+{
+    const auto values = m_counters.read();
+    const auto time = Clock::now();
+    auto & phase = m_stats.phases[static_cast<std::size_t>(m_active)];
+    phase.cycles += values.cycles - m_since_values.cycles;
+    phase.instructions += values.instructions - m_since_values.instructions;
+    phase.llc_misses += values.llc_misses - m_since_values.llc_misses;
+    phase.time_ns += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_since_time).count());
+    phase.entries++;
+    m_since_values = values;
+    m_since_time = time;
+}
+
+} // namespace util
@@ -0,0 +1,108 @@
+#include "util/ProblemFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace util {
+
+namespace {
+
+constexpr std::uint64_t ALIGNMENT = 64;
+
+std::uint64_t align_up(std::uint64_t offset)
+{
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+} // anonymous namespace
+
+/*static*/ ErrorOr<ProblemWriter> ProblemWriter::create(const std::string & path, std::size_t dims)
+{
+    if (dims == 0) {
+        return "zero-dimensional problem is not supported";
+    }
+    const std::uint64_t a_offset = align_up(sizeof(ProblemFileHeader));
+    const std::uint64_t b_offset = align_up(a_offset + dims * sizeof(double));
+    const std::uint64_t size = b_offset + dims * sizeof(double);
+
+    auto file = MappedFile::create(path, size);
+    if (auto err = std::get_if<std::string>(&file)) {
+        return std::move(*err);
+    }
+
+    ProblemWriter writer(std::move(std::get<std::shared_ptr<MappedFile>>(file)));
+    auto & hdr = *writer.m_header;
+    hdr.version = ProblemFileHeader::VERSION;
+    hdr.byte_order = ProblemFileHeader::ENDIAN_MARK;
+    hdr.dims = dims;
+    hdr.a_offset = a_offset;
+    hdr.b_offset = b_offset;
+    return writer;
+}
+
+MaybeErrorText ProblemWriter::finish(double c, double min_eigenvalue, double max_eigenvalue)
+{
+    m_header->c = c;
+    m_header->min_eigenvalue = min_eigenvalue;
+    m_header->max_eigenvalue = max_eigenvalue;
+    if (auto err = m_file->sync()) {
+        return err;
+    }
+    std::memcpy(m_header->magic, ProblemFileHeader::MAGIC, sizeof(ProblemFileHeader::MAGIC));
+    return m_file->sync();
+}
+
+ErrorOr<NFunction> load_problem(const std::string & path)
+{
+    auto mapped = MappedFile::open(path);
+    if (auto err = std::get_if<std::string>(&mapped)) {
+        return std::move(*err);
+    }
+    std::shared_ptr<const MappedFile> file = std::move(std::get<std::shared_ptr<MappedFile>>(mapped));
+
+    /*
+     * Validate header, so that a broken file is reported instead of read out of bounds.
+     */
+    if (file->size() < sizeof(ProblemFileHeader)) {
+        return "'" + path + "' is too small to be a problem file";
+    }
+    const auto & hdr = *static_cast<const ProblemFileHeader *>(file->data());
+    if (std::memcmp(hdr.magic, ProblemFileHeader::MAGIC, sizeof(hdr.magic)) != 0) {
+        return "'" + path + "' is not a problem file or was not written completely";
+    }
+    if (hdr.byte_order != ProblemFileHeader::ENDIAN_MARK) {
+        return "'" + path + "' was written on a machine with different byte order";
+    }
+    if (hdr.version != ProblemFileHeader::VERSION) {
+        return "'" + path + "' has unsupported version " + std::to_string(hdr.version);
+    }
+    const std::uint64_t bytes = hdr.dims * sizeof(double);
+    auto fits = [&](std::uint64_t offset) {
+        return offset % alignof(double) == 0 && offset >= sizeof(ProblemFileHeader) && offset <= file->size() && bytes <= file->size() - offset;
+    };
+    if (hdr.dims == 0 || hdr.dims > file->size() / sizeof(double) || !fits(hdr.a_offset) || !fits(hdr.b_offset)) {
+        return "'" + path + "' has inconsistent header";
+    }
+
+    const auto * base = static_cast<const char *>(file->data());
+    ConstArray<double> a(reinterpret_cast<const double *>(base + hdr.a_offset), hdr.dims, file);
+    ConstArray<double> b(reinterpret_cast<const double *>(base + hdr.b_offset), hdr.dims, file);
+    return NFunction(DiagMatrix(std::move(a)), std::move(b), hdr.c, hdr.max_eigenvalue);
+}
+
+MaybeErrorText save_problem(const std::string & path, const NFunction & func)
+{
+    auto created = ProblemWriter::create(path, func.dims());
+    if (auto err = std::get_if<std::string>(&created)) {
+        return std::move(*err);
+    }
+    auto & writer = std::get<ProblemWriter>(created);
+
+    const auto & diag = func.a().diag();
+    std::copy(diag.begin(), diag.end(), writer.a());
+    std::copy(func.b().begin(), func.b().end(), writer.b());
+    const auto [min, max] = std::minmax_element(diag.begin(), diag.end());
+    return writer.finish(func.c(), *min, std::max(*max, func.eigenvalue()));
+}
+
+} // namespace util
@@ -0,0 +1,314 @@
+#include "util/ProblemGenerator.h"
+
+#include "util/DiagMatrix.h"
+#include "util/Philox.h"
+#include "util/ProblemFile.h"
+#include "util/Vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace util {
+
+namespace {
+
+/*
+ * Independent random sequences used by the generator.
+ */
+enum Stream : std::uint64_t
+{
+    STREAM_A = 0,
+    STREAM_B = 1,
+    STREAM_SPARSE = 2,
+};
+
+constexpr std::size_t CHUNK = 1 << 16; // elements filled by one task, even, so that chunks do not split pairs
+
+/*
+ * The i-th uniform number of the stream: one block of Philox gives numbers 2k and 2k + 1.
+ */
+double uniform_at(const Philox & gen, std::uint64_t stream, std::size_t i) noexcept
+{
+    const auto block = gen(i / 2, stream);
+    return i % 2 == 0 ? Philox::to_unit(block[0], block[1]) : Philox::to_unit(block[2], block[3]);
+}
+
+/*
+ * out[i] = transform(uniform_at(gen, stream, i)) for i in [from, to), from is even.
+ */
+template <class Transform>
+void fill_uniform(const Philox & gen, std::uint64_t stream, std::size_t from, std::size_t to, double * out, Transform && transform)
+{
+    for (std::size_t i = from; i < to; i += 2) {
+        const auto block = gen(i / 2, stream);
+        out[i] = transform(Philox::to_unit(block[0], block[1]));
+        if (i + 1 < to) {
+            out[i + 1] = transform(Philox::to_unit(block[2], block[3]));
+        }
+    }
+}
+
+/*
+ * Call func(from, to) for consecutive chunks of [0, count), in parallel, if there is a pool.
+ * Chunks do not depend on the number of threads.
+ */
+template <class Func>
+void for_chunks(std::size_t count, ThreadPool * pool, Func && func)
+{
+    const std::size_t chunks = (count + CHUNK - 1) / CHUNK;
+    auto run = [&](std::size_t chunk) { func(chunk * CHUNK, std::min(count, (chunk + 1) * CHUNK)); };
+    if (pool) {
+        pool->parallel_for(chunks, run);
+    } else {
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            run(chunk);
+        }
+    }
+}
+
+double cluster_center(const ProblemSpec & spec, std::size_t cluster) noexcept
+{
+    const double cond = spec.max_eigenvalue / spec.min_eigenvalue;
+    if (spec.clusters == 1) {
+        return spec.min_eigenvalue * std::sqrt(cond);
+    }
+    return spec.min_eigenvalue * std::pow(cond, static_cast<double>(cluster) / static_cast<double>(spec.clusters - 1));
+}
+
+double clustered_at(const ProblemSpec & spec, const Philox & gen, std::size_t i) noexcept
+{
+    const auto block = gen(i, STREAM_A);
+    const double center = cluster_center(spec, (static_cast<std::uint64_t>(block[0]) << 32 | block[1]) % spec.clusters);
+    const double offset = spec.cluster_width * (2 * Philox::to_unit(block[2], block[3]) - 1);
+    return std::clamp(center * (1 + offset), spec.min_eigenvalue, spec.max_eigenvalue);
+}
+
+/*
+ * The i-th eigenvalue, the same as generate_problem puts to a[i] (up to rounding for geometric spectrum).
+ */
+double eigenvalue_at(const ProblemSpec & spec, const Philox & gen, std::size_t i) noexcept
+{
+    if (i == 0) {
+        return spec.min_eigenvalue;
+    }
+    if (i + 1 == spec.dims) {
+        return spec.max_eigenvalue;
+    }
+    switch (spec.spectrum) {
+    case Spectrum::Uniform:
+        return spec.min_eigenvalue + (spec.max_eigenvalue - spec.min_eigenvalue) * uniform_at(gen, STREAM_A, i);
+    case Spectrum::Geometric:
+        return spec.min_eigenvalue * std::pow(spec.max_eigenvalue / spec.min_eigenvalue, static_cast<double>(i) / static_cast<double>(spec.dims - 1));
+    case Spectrum::Clustered:
+        return clustered_at(spec, gen, i);
+    }
+    return spec.min_eigenvalue;
+}
+
+void fill_spectrum(const ProblemSpec & spec, const Philox & gen, std::size_t from, std::size_t to, double * a)
+{
+    const double min = spec.min_eigenvalue;
+    const double max = spec.max_eigenvalue;
+    switch (spec.spectrum) {
+    case Spectrum::Uniform:
+        fill_uniform(gen, STREAM_A, from, to, a, [min, max](double u) { return min + (max - min) * u; });
+        break;
+    case Spectrum::Geometric: {
+        /*
+         * pow is calculated once per chunk, inside of it the progression is continued by multiplication.
+         */
+        const double exp_step = spec.dims > 1 ? 1. / static_cast<double>(spec.dims - 1) : 0.;
+        const double ratio = std::pow(max / min, exp_step);
+        double value = min * std::pow(max / min, static_cast<double>(from) * exp_step);
+        for (std::size_t i = from; i < to; ++i, value *= ratio) {
+            a[i] = std::min(value, max);
+        }
+        break;
+    }
+    case Spectrum::Clustered:
+        for (std::size_t i = from; i < to; ++i) {
+            a[i] = clustered_at(spec, gen, i);
+        }
+        break;
+    }
+    if (from == 0) {
+        a[0] = min;
+    }
+    if (to == spec.dims) {
+        a[to - 1] = max;
+    }
+}
+
+/*
+ * Off-diagonal entry with number k of row row above the diagonal.
+ * Returns false, if it falls out of the matrix.
+ */
+bool upper_entry(const Philox & gen, std::size_t row, std::size_t k, std::size_t per_row, std::size_t bandwidth, std::size_t dims, std::uint32_t & col, double & value)
+{
+    const auto block = gen(static_cast<std::uint64_t>(row) * per_row + k, STREAM_SPARSE);
+    const std::size_t offset = 1 + block[0] % bandwidth;
+    if (offset >= dims - row) {
+        return false;
+    }
+    col = static_cast<std::uint32_t>(row + offset);
+    value = 2 * Philox::to_unit(block[2], block[3]) - 1;
+    return true;
+}
+
+struct Entry
+{
+    std::uint32_t col;
+    double value;
+};
+
+/*
+ * Build row of the sparse matrix in entries, sorted by column.
+ * Entries below the diagonal are the upper entries of previous rows, which point to this row.
+ */
+void assemble_row(const ProblemSpec & spec, const Philox & gen, std::size_t row, std::size_t per_row, std::size_t bandwidth, std::vector<Entry> & entries)
+{
+    entries.clear();
+    Entry entry;
+    for (std::size_t k = 0; k < per_row; ++k) {
+        if (upper_entry(gen, row, k, per_row, bandwidth, spec.dims, entry.col, entry.value)) {
+            entries.push_back(entry);
+        }
+    }
+    for (std::size_t other = row > bandwidth ? row - bandwidth : 0; other < row; ++other) {
+        for (std::size_t k = 0; k < per_row; ++k) {
+            if (upper_entry(gen, other, k, per_row, bandwidth, spec.dims, entry.col, entry.value) && entry.col == row) {
+                entries.push_back({static_cast<std::uint32_t>(other), entry.value});
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry & lhs, const Entry & rhs) { return lhs.col < rhs.col; });
+    std::size_t size = 0;
+    double off_diag_sum = 0.;
+    for (const auto & e : entries) {
+        if (size > 0 && entries[size - 1].col == e.col) {
+            entries[size - 1].value += e.value;
+        } else {
+            entries[size++] = e;
+        }
+    }
+    entries.resize(size);
+    for (const auto & e : entries) {
+        off_diag_sum += std::abs(e.value);
+    }
+
+    const Entry diag{static_cast<std::uint32_t>(row), eigenvalue_at(spec, gen, row) + off_diag_sum};
+    entries.insert(std::lower_bound(entries.begin(), entries.end(), diag, [](const Entry & lhs, const Entry & rhs) { return lhs.col < rhs.col; }), diag);
+}
+
+} // anonymous namespace
+
+MaybeErrorText validate(const ProblemSpec & spec)
+{
+    if (spec.dims == 0) {
+        return "zero-dimensional problem is not supported";
+    }
+    if (!(spec.min_eigenvalue > 0 && spec.min_eigenvalue <= spec.max_eigenvalue && std::isfinite(spec.max_eigenvalue))) {
+        return "eigenvalues must satisfy 0 < min <= max < inf";
+    }
+    if (spec.spectrum == Spectrum::Clustered && spec.clusters == 0) {
+        return "clustered spectrum needs at least one cluster";
+    }
+    if (!(spec.cluster_width >= 0 && spec.cluster_width < 1)) {
+        return "cluster width must be in [0, 1)";
+    }
+    if (!(spec.b_range >= 0 && std::isfinite(spec.b_range))) {
+        return "range of b must be finite and non-negative";
+    }
+    return std::nullopt;
+}
+
+MaybeErrorText generate_problem(const ProblemSpec & spec, double * a, double * b, ThreadPool * pool)
+{
+    if (auto err = validate(spec)) {
+        return err;
+    }
+    const Philox gen(spec.seed);
+    const double b_range = spec.b_range;
+    for_chunks(spec.dims, pool, [&](std::size_t from, std::size_t to) {
+        fill_spectrum(spec, gen, from, to, a);
+        fill_uniform(gen, STREAM_B, from, to, b, [b_range](double u) { return b_range * (2 * u - 1); });
+    });
+    return std::nullopt;
+}
+
+ErrorOr<NFunction> generate_problem(const ProblemSpec & spec, ThreadPool * pool)
+{
+    if (auto err = validate(spec)) {
+        return std::move(*err);
+    }
+    std::vector<double> a(spec.dims);
+    std::vector<double> b(spec.dims);
+    generate_problem(spec, a.data(), b.data(), pool);
+    return NFunction(DiagMatrix(std::move(a)), Vector(std::move(b)), spec.c, spec.max_eigenvalue);
+}
+
+MaybeErrorText generate_problem_file(const std::string & path, const ProblemSpec & spec, ThreadPool * pool)
+{
+    if (auto err = validate(spec)) {
+        return err;
+    }
+    auto writer = ProblemWriter::create(path, spec.dims);
+    if (auto err = std::get_if<std::string>(&writer)) {
+        return std::move(*err);
+    }
+    auto & out = std::get<ProblemWriter>(writer);
+    generate_problem(spec, out.a(), out.b(), pool);
+    return out.finish(spec.c, spec.min_eigenvalue, spec.max_eigenvalue);
+}
+
+ErrorOr<SparseMatrix> generate_sparse_spd(const ProblemSpec & spec, std::size_t per_row, std::size_t bandwidth, ThreadPool * pool)
+{
+    if (auto err = validate(spec)) {
+        return std::move(*err);
+    }
+    if (spec.dims > std::numeric_limits<std::uint32_t>::max()) {
+        return "sparse matrix is too large";
+    }
+    if (per_row > 0 && bandwidth == 0) {
+        return "bandwidth must be positive";
+    }
+
+    const Philox gen(spec.seed);
+    const std::size_t rows = spec.dims;
+
+    /*
+     * First pass counts entries of each row, second one fills the rows at known positions.
+     */
+    std::vector<std::size_t> row_starts(rows + 1, 0);
+    for_chunks(rows, pool, [&](std::size_t from, std::size_t to) {
+        std::vector<Entry> entries;
+        for (std::size_t row = from; row < to; ++row) {
+            assemble_row(spec, gen, row, per_row, bandwidth, entries);
+            row_starts[row + 1] = entries.size();
+        }
+    });
+    for (std::size_t row = 0; row < rows; ++row) {
+        row_starts[row + 1] += row_starts[row];
+    }
+
+    std::vector<std::uint32_t> cols(row_starts.back());
+    std::vector<double> values(row_starts.back());
+    for_chunks(rows, pool, [&](std::size_t from, std::size_t to) {
+        std::vector<Entry> entries;
+        for (std::size_t row = from; row < to; ++row) {
+            assemble_row(spec, gen, row, per_row, bandwidth, entries);
+            std::size_t pos = row_starts[row];
+            for (const auto & e : entries) {
+                cols[pos] = e.col;
+                values[pos] = e.value;
+                ++pos;
+            }
+        }
+    });
+    return SparseMatrix(std::move(row_starts), std::move(cols), std::move(values));
+}
+
+} // namespace util
@@ -0,0 +1,104 @@
+#include "util/ProcessGroup.h"
+
+#include <dirent.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace util {
+
+std::size_t thread_count()
+{
+    DIR * dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+        return 0;
+    }
+    std::size_t res = 0;
+    while (const dirent * entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            ++res;
+        }
+    }
+    closedir(dir);
+    return res;
+}
+
+std::optional<std::string> ProcessGroup::run(const Body & body)
+{
+    if (m_processes > 1 && thread_count() != 1) {
+        return "ProcessGroup: cannot fork from a process with several threads";
+    }
+
+    m_parent = getpid();
+    m_children.clear();
+    m_children.reserve(m_processes);
+    for (std::size_t rank = 1; rank < m_processes; ++rank) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            m_is_worker = true;
+            m_children.clear();
+            int code = 0;
+            try {
+                body(rank);
+            } catch (...) {
+                code = 1;
+            }
+            _exit(code); // do not run parent's atexit handlers and destructors
+        }
+        if (pid < 0) {
+            /*
+             * Workers already started are waiting for the missing ones on barriers, so they cannot be joined.
+             */
+            kill_workers();
+            return "ProcessGroup: fork failed";
+        }
+        m_children.push_back(pid);
+    }
+
+    try {
+        body(0);
+    } catch (...) {
+        kill_workers();
+        throw;
+    }
+
+    bool failed = false;
+    for (auto child : m_children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        failed |= !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+    m_children.clear();
+    if (failed) {
+        return "ProcessGroup: worker process failed";
+    }
+    return std::nullopt;
+}
+
+/*
+ * Exited workers are not reaped here (WNOWAIT), run() collects their statuses.
+ */
+bool ProcessGroup::peers_alive() const
+{
+    if (m_is_worker) {
+        return getppid() == m_parent;
+    }
+    for (auto child : m_children) {
+        siginfo_t info{};
+        if (waitid(P_PID, child, &info, WEXITED | WNOHANG | WNOWAIT) != 0 || info.si_pid != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ProcessGroup::kill_workers()
+{
+    for (auto child : m_children) {
+        kill(child, SIGKILL);
+        waitpid(child, nullptr, 0);
+    }
+    m_children.clear();
+}
+
+} // namespace util
@@ -0,0 +1,335 @@
+#include "util/ReplayColumns.h"
+
+#include "util/BufferedWriter.h"
+#include "util/Vector.h"
+#include "util/VersionedData.h"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace util {
+
+namespace {
+
+/*
+ * Column as a piece of memory: numeric values or text offsets in data, characters of a text column in text.
+ */
+struct ColumnView
+{
+    std::string_view name;
+    ColumnType type;
+    std::uint32_t width;
+    std::string_view data;
+    std::string_view text;
+};
+
+struct TableView
+{
+    std::string_view name;
+    std::size_t rows;
+    std::vector<ColumnView> columns;
+};
+
+template <class T>
+std::string_view as_bytes(const std::vector<T> & values)
+{
+    return {reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T)};
+}
+
+template <class T>
+ColumnView numeric(std::string_view name, const std::vector<T> & values, std::uint32_t width = 1)
+{
+    constexpr ColumnType type = std::is_same_v<T, double> ? ColumnType::Float64 : (sizeof(T) == 4 ? ColumnType::UInt32 : ColumnType::UInt64);
+    return {name, type, width, as_bytes(values), {}};
+}
+
+TableView describe(std::string_view name, const ReplayColumns::Table & table, std::initializer_list<ColumnView> columns)
+{
+    TableView view{name, table.rows(), {numeric("version", table.versions), numeric("position", table.positions)}};
+    view.columns.insert(view.columns.end(), columns);
+    return view;
+}
+
+std::vector<TableView> describe(const ReplayColumns & cols)
+{
+    const auto & pt = cols.points;
+    const auto & par = cols.paraboles;
+    const auto & seg = cols.segments;
+    const auto & com = cols.comments;
+    const auto & vec = cols.vectors;
+    return {
+            describe("point", pt, {numeric("x", pt.x), numeric("y", pt.y)}),
+            describe("parabole", par, {numeric("a", par.a), numeric("b", par.b), numeric("c", par.c)}),
+            describe("segment", seg, {numeric("l", seg.l), numeric("r", seg.r)}),
+            describe("comment", com, {{"comment", ColumnType::Text, 1, as_bytes(com.offsets), com.text}}),
+            describe("double", cols.doubles, {numeric("value", cols.doubles.values)}),
+            describe("vector", vec, {numeric("dims", vec.dims), numeric("v", vec.values, vec.width)}),
+    };
+}
+
+/*
+ * Create (or truncate) the file and write it through func(BufferedWriter &).
+ */
+template <class Func>
+MaybeErrorText write_file(const std::string & path, Func && func)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return "cannot open '" + path + "': " + std::strerror(errno);
+    }
+    MaybeErrorText err;
+    {
+        BufferedWriter out(fd);
+        func(out);
+        err = out.flush();
+    }
+    ::close(fd);
+    return err;
+}
+
+/*
+ * Writer, which keeps track of the current offset to align column data.
+ */
+struct BinaryWriter
+{
+    template <class T>
+    void put(const T & value)
+    {
+        raw({reinterpret_cast<const char *>(&value), sizeof(T)});
+    }
+
+    void name(std::string_view name)
+    {
+        put(static_cast<std::uint32_t>(name.size()));
+        raw(name);
+    }
+
+    void align()
+    {
+        static constexpr char zeros[8] = {};
+        raw({zeros, (8 - offset % 8) % 8});
+    }
+
+    void raw(std::string_view bytes)
+    {
+        out.write(bytes);
+        offset += bytes.size();
+    }
+
+    BufferedWriter & out;
+    std::size_t offset = 0;
+};
+
+void append_number(std::string & out, double value)
+{
+    char buf[32];
+    out.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+}
+
+void append_number(std::string & out, std::uint64_t value)
+{
+    char buf[24];
+    out.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+}
+
+void append_text(std::string & out, std::string_view text)
+{
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out += text;
+        return;
+    }
+    out += '"';
+    for (const char c : text) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+void append_cell(std::string & out, const ColumnView & col, std::size_t idx)
+{
+    switch (col.type) {
+    case ColumnType::UInt32:
+        append_number(out, std::uint64_t{reinterpret_cast<const std::uint32_t *>(col.data.data())[idx]});
+        break;
+    case ColumnType::UInt64:
+        append_number(out, reinterpret_cast<const std::uint64_t *>(col.data.data())[idx]);
+        break;
+    case ColumnType::Float64:
+        append_number(out, reinterpret_cast<const double *>(col.data.data())[idx]);
+        break;
+    case ColumnType::Text: {
+        const auto * offsets = reinterpret_cast<const std::uint64_t *>(col.data.data());
+        append_text(out, col.text.substr(offsets[idx], offsets[idx + 1] - offsets[idx]));
+        break;
+    }
+    }
+}
+
+void write_csv(BufferedWriter & out, const TableView & table)
+{
+    std::string line;
+    auto separate = [&line] {
+        if (!line.empty()) {
+            line += ',';
+        }
+    };
+    for (const auto & col : table.columns) {
+        for (std::uint32_t k = 0; k < col.width; ++k) {
+            separate();
+            line += col.name;
+            if (col.width > 1) {
+                append_number(line, std::uint64_t{k});
+            }
+        }
+    }
+    line += '\n';
+    out.write(line);
+
+    for (std::size_t row = 0; row < table.rows; ++row) {
+        line.clear();
+        for (const auto & col : table.columns) {
+            for (std::uint32_t k = 0; k < col.width; ++k) {
+                separate();
+                append_cell(line, col, row * col.width + k);
+            }
+        }
+        line += '\n';
+        out.write(line);
+    }
+}
+
+} // anonymous namespace
+
+ReplayColumns split_columns(const ReplayData & data)
+{
+    ReplayColumns cols;
+
+    /*
+     * Count records of each kind first, so that columns are allocated once.
+     * Vectors' width has to be known before the first one is stored anyway.
+     */
+    std::size_t counts[static_cast<std::size_t>(VdDataKind::VdVectorKind) + 1] = {};
+    for (const auto & record : data) {
+        const auto kind = record->get_kind();
+        ++counts[static_cast<std::size_t>(kind)];
+        if (kind == VdDataKind::VdVectorKind) {
+            const auto dims = static_cast<const VdVector &>(*record).vec().dims();
+            cols.vectors.width = std::max(cols.vectors.width, static_cast<std::uint32_t>(dims));
+        }
+    }
+    auto reserve = [&counts](VdDataKind kind, ReplayColumns::Table & table, auto &... columns) {
+        const std::size_t rows = counts[static_cast<std::size_t>(kind)];
+        table.versions.reserve(rows);
+        table.positions.reserve(rows);
+        (columns.reserve(rows), ...);
+        return rows;
+    };
+    reserve(VdDataKind::VdPointKind, cols.points, cols.points.x, cols.points.y);
+    reserve(VdDataKind::VdParaboleKind, cols.paraboles, cols.paraboles.a, cols.paraboles.b, cols.paraboles.c);
+    reserve(VdDataKind::VdSegmentKind, cols.segments, cols.segments.l, cols.segments.r);
+    cols.comments.offsets.reserve(reserve(VdDataKind::VdCommentKind, cols.comments) + 1);
+    reserve(VdDataKind::VdDoubleKind, cols.doubles, cols.doubles.values);
+    cols.vectors.values.reserve(reserve(VdDataKind::VdVectorKind, cols.vectors, cols.vectors.dims) * cols.vectors.width);
+
+    std::uint64_t position = 0;
+    auto add_row = [&position](ReplayColumns::Table & table, const VersionedData & record) {
+        table.versions.push_back(record.version());
+        table.positions.push_back(position);
+    };
+    const auto splitter = overload(
+            [&](const VdPoint & point) {
+                add_row(cols.points, point);
+                cols.points.x.push_back(point.x);
+                cols.points.y.push_back(point.y);
+            },
+            [&](const VdParabole & parabole) {
+                add_row(cols.paraboles, parabole);
+                cols.paraboles.a.push_back(parabole.a);
+                cols.paraboles.b.push_back(parabole.b);
+                cols.paraboles.c.push_back(parabole.c);
+            },
+            [&](const VdSegment & segment) {
+                add_row(cols.segments, segment);
+                cols.segments.l.push_back(segment.l);
+                cols.segments.r.push_back(segment.r);
+            },
+            [&](const VdComment & comment) {
+                add_row(cols.comments, comment);
+                cols.comments.text += comment.comment;
+                cols.comments.offsets.push_back(cols.comments.text.size());
+            },
+            [&](const VdDouble & dbl) {
+                add_row(cols.doubles, dbl);
+                cols.doubles.values.push_back(dbl.value);
+            },
+            [&](const VdVector & vector) {
+                add_row(cols.vectors, vector);
+                const auto & vec = vector.vec();
+                cols.vectors.dims.push_back(static_cast<std::uint32_t>(vec.dims()));
+                cols.vectors.values.insert(cols.vectors.values.end(), vec.data(), vec.data() + vec.dims());
+                cols.vectors.values.resize(cols.vectors.values.size() + cols.vectors.width - vec.dims(), std::numeric_limits<double>::quiet_NaN());
+            });
+    for (const auto & record : data) {
+        record->call_func(splitter);
+        ++position;
+    }
+    return cols;
+}
+
+MaybeErrorText save_replay_columns(const std::string & path, const ReplayColumns & columns)
+{
+    const auto tables = describe(columns);
+    return write_file(path, [&tables](BufferedWriter & out) {
+        BinaryWriter writer{out};
+
+        ReplayFileHeader header{};
+        std::memcpy(header.magic, ReplayFileHeader::MAGIC, sizeof(header.magic));
+        header.version = ReplayFileHeader::VERSION;
+        header.byte_order = ReplayFileHeader::ENDIAN_MARK;
+        header.tables = static_cast<std::uint32_t>(tables.size());
+        writer.put(header);
+
+        for (const auto & table : tables) {
+            writer.name(table.name);
+            writer.put(static_cast<std::uint32_t>(table.columns.size()));
+            writer.put(static_cast<std::uint64_t>(table.rows));
+            for (const auto & col : table.columns) {
+                writer.name(col.name);
+                writer.put(static_cast<std::uint8_t>(col.type));
+                writer.put(col.width);
+                writer.put(static_cast<std::uint64_t>(col.data.size() + col.text.size()));
+                writer.align();
+                writer.raw(col.data);
+                writer.raw(col.text);
+                writer.align();
+            }
+        }
+    });
+}
+
+MaybeErrorText save_replay_csv(const std::string & prefix, const ReplayColumns & columns)
+{
+    for (const auto & table : describe(columns)) {
+        if (table.rows == 0) {
+            continue;
+        }
+        const std::string path = prefix + "." + std::string(table.name) + ".csv";
+        if (auto err = write_file(path, [&table](BufferedWriter & out) { write_csv(out, table); })) {
+            return err;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace util
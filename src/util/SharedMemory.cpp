@@ -0,0 +1,162 @@
+#include "util/SharedMemory.h"
+
+#include <cassert>
+#include <cerrno>
+#include <ctime>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace util {
+
+ShmRegion::ShmRegion(std::size_t size)
+{
+    void * data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (data != MAP_FAILED) {
+        m_data = data;
+        m_size = size;
+    }
+}
+
+ShmRegion::~ShmRegion()
+{
+    if (m_data) {
+        munmap(m_data, m_size);
+    }
+}
+
+ShmCommunicator::ShmCommunicator(std::size_t processes)
+    : m_processes(processes)
+    , m_region(sizeof(Header) + 2 * processes * MAX_VALUES * sizeof(double))
+{
+    assert(processes > 0 && "ShmCommunicator needs at least one process");
+    if (!m_region.valid()) {
+        return;
+    }
+
+    auto * hdr = new (m_region.data()) Header;
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&hdr->mutex, &mutex_attr);
+    pthread_mutexattr_destroy(&mutex_attr);
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&hdr->cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+}
+
+/*
+ * The mutex and the condition are not destroyed, the region is just unmapped: pthread_cond_destroy waits for
+ * the waiters, and a process killed inside of pthread_cond_timedwait would never leave.
+ * Process-shared objects own nothing besides their memory.
+ */
+ShmCommunicator::~ShmCommunicator() = default;
+
+void ShmCommunicator::lock() const noexcept
+{
+    if (pthread_mutex_lock(&header().mutex) == EOWNERDEAD) {
+        pthread_mutex_consistent(&header().mutex);
+        header().aborted = true;
+        pthread_cond_broadcast(&header().cond);
+    }
+}
+
+void ShmCommunicator::unlock() const noexcept
+{
+    pthread_mutex_unlock(&header().mutex);
+}
+
+void ShmCommunicator::abort() noexcept
+{
+    lock();
+    header().aborted = true;
+    pthread_cond_broadcast(&header().cond);
+    unlock();
+}
+
+bool ShmCommunicator::aborted() const noexcept
+{
+    lock();
+    const bool res = header().aborted;
+    unlock();
+    return res;
+}
+
+double * ShmCommunicator::slot(std::size_t parity, std::size_t rank) const noexcept
+{
+    auto * slots = reinterpret_cast<double *>(static_cast<char *>(m_region.data()) + sizeof(Header));
+    return slots + (parity * m_processes + rank) * MAX_VALUES;
+}
+
+bool ShmCommunicator::allreduce_sum(std::size_t rank, double * values, std::size_t count)
+{
+    assert(count <= MAX_VALUES && "ShmCommunicator: too many values to reduce");
+
+    double * own = slot(m_parity, rank);
+    for (std::size_t i = 0; i < count; ++i) {
+        own[i] = values[i];
+    }
+    if (!barrier()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i] = 0.;
+    }
+    for (std::size_t r = 0; r < m_processes; ++r) {
+        const double * other = slot(m_parity, r);
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i] += other[i];
+        }
+    }
+    m_parity ^= 1;
+    return true;
+}
+
+/*
+ * Completion of the barrier is checked before the watchdog: a peer may exit right after passing the last barrier.
+ */
+bool ShmCommunicator::barrier()
+{
+    auto & hdr = header();
+    lock();
+    if (hdr.aborted) {
+        unlock();
+        return false;
+    }
+    const std::size_t generation = hdr.generation;
+    if (++hdr.arrived == m_processes) {
+        hdr.arrived = 0;
+        ++hdr.generation;
+        pthread_cond_broadcast(&hdr.cond);
+        unlock();
+        return true;
+    }
+    while (hdr.generation == generation && !hdr.aborted) {
+        timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += POLL_INTERVAL_MS * 1000000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+        const int rc = pthread_cond_timedwait(&hdr.cond, &hdr.mutex, &deadline);
+        if (rc == EOWNERDEAD) {
+            pthread_mutex_consistent(&hdr.mutex);
+            hdr.aborted = true;
+        } else if (rc == ETIMEDOUT && hdr.generation == generation && m_watchdog && !m_watchdog()) {
+            hdr.aborted = true;
+        }
+    }
+    const bool passed = hdr.generation != generation;
+    if (!passed) {
+        pthread_cond_broadcast(&hdr.cond);
+    }
+    unlock();
+    return passed;
+}
+
+} // namespace util
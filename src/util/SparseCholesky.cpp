@@ -0,0 +1,351 @@
+#include "util/SparseCholesky.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <utility>
+
+namespace util {
+
+namespace {
+
+constexpr std::uint32_t NO_PARENT = std::numeric_limits<std::uint32_t>::max();
+
+std::string not_positive_definite(std::size_t row)
+{
+    return "matrix is not positive definite (pivot of row " + std::to_string(row) + " is not positive)";
+}
+
+/*
+ * Approximate minimum degree ordering on the quotient graph.
+ * Eliminated vertex p becomes an element: instead of adding the clique of its neighbours to the graph,
+ * the neighbours remember p, and p remembers them (its boundary, the pattern of column p of L).
+ * Elements adjacent to p are absorbed by it, so the graph never grows beyond the size of A.
+ * Degree of a neighbour i is bounded from above by its variables, the boundary of p and the parts of
+ * other elements of i outside of p's boundary, as in AMD; supervariables are not detected.
+ * Ties are broken by the smaller index, so the ordering is deterministic.
+ */
+std::vector<std::uint32_t> minimum_degree(const SparseMatrix & a)
+{
+    enum class State : char
+    {
+        Variable,
+        Element,
+        Absorbed,
+    };
+
+    const std::size_t n = a.dims();
+    std::vector<std::vector<std::uint32_t>> vars(n);  // adjacent variables
+    std::vector<std::vector<std::uint32_t>> elems(n); // adjacent elements
+    std::vector<std::vector<std::uint32_t>> boundaries(n); // variables adjacent to element
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t pos = a.row_starts()[i]; pos < a.row_starts()[i + 1]; ++pos) {
+            const std::uint32_t j = a.cols()[pos];
+            if (j != i) {
+                vars[i].push_back(j);
+                vars[j].push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+    }
+
+    using Entry = std::pair<std::size_t, std::uint32_t>; // degree, vertex
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<std::size_t> degrees(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::sort(vars[i].begin(), vars[i].end());
+        vars[i].erase(std::unique(vars[i].begin(), vars[i].end()), vars[i].end());
+        degrees[i] = vars[i].size();
+        queue.emplace(degrees[i], static_cast<std::uint32_t>(i));
+    }
+
+    std::vector<State> states(n, State::Variable);
+    std::vector<std::size_t> in_boundary(n, n); // step, at which the variable was put to the new boundary
+    std::vector<std::size_t> outside(n);        // size of element's boundary outside of the new one
+    std::vector<std::size_t> outside_step(n, n);
+    std::vector<std::uint32_t> perm;
+    perm.reserve(n);
+    while (!queue.empty()) {
+        const auto [degree, p] = queue.top();
+        queue.pop();
+        if (states[p] != State::Variable || degree != degrees[p]) {
+            continue; // stale entry, the vertex was queued again with its new degree
+        }
+        const std::size_t step = perm.size();
+        perm.push_back(p);
+        states[p] = State::Element;
+
+        /*
+         * Boundary of p: its variables and boundaries of its elements, which are absorbed.
+         */
+        auto & boundary = boundaries[p];
+        in_boundary[p] = step;
+        auto add = [&](std::uint32_t v) {
+            if (states[v] == State::Variable && in_boundary[v] != step) {
+                in_boundary[v] = step;
+                boundary.push_back(v);
+            }
+        };
+        for (const auto v : vars[p]) {
+            add(v);
+        }
+        for (const auto e : elems[p]) {
+            if (states[e] == State::Element) {
+                for (const auto v : boundaries[e]) {
+                    add(v);
+                }
+                states[e] = State::Absorbed;
+                boundaries[e] = {};
+            }
+        }
+        vars[p] = {};
+        elems[p] = {};
+
+        for (const auto i : boundary) {
+            for (const auto e : elems[i]) {
+                if (states[e] == State::Element) {
+                    if (outside_step[e] != step) {
+                        outside_step[e] = step;
+                        outside[e] = boundaries[e].size();
+                    }
+                    --outside[e];
+                }
+            }
+        }
+        const std::size_t remaining = n - perm.size();
+        for (const auto i : boundary) {
+            auto & i_elems = elems[i];
+            i_elems.erase(std::remove_if(i_elems.begin(), i_elems.end(), [&](std::uint32_t e) { return states[e] != State::Element; }), i_elems.end());
+            auto & i_vars = vars[i];
+            i_vars.erase(std::remove_if(i_vars.begin(), i_vars.end(), [&](std::uint32_t v) { return states[v] != State::Variable || in_boundary[v] == step; }), i_vars.end());
+
+            std::size_t external = 0;
+            for (const auto e : i_elems) {
+                external += outside[e];
+            }
+            i_elems.push_back(p);
+            degrees[i] = std::min({remaining - 1, degrees[i] + boundary.size() - 1, i_vars.size() + boundary.size() - 1 + external});
+            queue.emplace(degrees[i], i);
+        }
+    }
+    return perm;
+}
+
+/*
+ * Lower triangle of P A P^T in compressed rows, without the diagonal, which is kept separately.
+ */
+struct LowerTriangle
+{
+    std::vector<std::size_t> row_starts;
+    std::vector<std::uint32_t> cols;
+    std::vector<double> values;
+    std::vector<double> diag;
+
+    LowerTriangle(const SparseMatrix & a, const std::vector<std::uint32_t> & perm)
+        : row_starts(1, 0)
+        , diag(a.dims(), 0.)
+    {
+        const std::size_t n = a.dims();
+        std::vector<std::uint32_t> inverse(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            inverse[perm[k]] = static_cast<std::uint32_t>(k);
+        }
+        row_starts.reserve(n + 1);
+        cols.reserve(a.nnz() / 2);
+        values.reserve(a.nnz() / 2);
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t i = perm[k];
+            for (std::size_t pos = a.row_starts()[i]; pos < a.row_starts()[i + 1]; ++pos) {
+                const std::uint32_t j = inverse[a.cols()[pos]];
+                if (j < k) {
+                    cols.push_back(j);
+                    values.push_back(a.values()[pos]);
+                } else if (j == k) {
+                    diag[k] += a.values()[pos];
+                }
+            }
+            row_starts.push_back(cols.size());
+        }
+    }
+};
+
+/*
+ * Elimination tree of the lower triangle: parent of column j is the first row below j, where L has a nonzero in column j.
+ */
+std::vector<std::uint32_t> elimination_tree(const LowerTriangle & c)
+{
+    const std::size_t n = c.diag.size();
+    std::vector<std::uint32_t> parent(n, NO_PARENT);
+    std::vector<std::uint32_t> ancestor(n, NO_PARENT); // shortcuts to the roots of the subtrees found so far
+    for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t pos = c.row_starts[k]; pos < c.row_starts[k + 1]; ++pos) {
+            std::uint32_t j = c.cols[pos];
+            while (j != NO_PARENT && j < k) {
+                const std::uint32_t next = ancestor[j];
+                ancestor[j] = static_cast<std::uint32_t>(k);
+                if (next == NO_PARENT) {
+                    parent[j] = static_cast<std::uint32_t>(k);
+                }
+                j = next;
+            }
+        }
+    }
+    return parent;
+}
+
+/*
+ * Pattern of row k of L: the columns reachable in the elimination tree from the nonzeros of row k of the lower triangle.
+ * It is written to stack[top, n) in topological order (descendants before ancestors), top is returned.
+ * Columns are marked with k in marks.
+ */
+std::size_t row_pattern(const LowerTriangle & c, std::size_t k, const std::vector<std::uint32_t> & parent, std::vector<std::size_t> & marks, std::vector<std::uint32_t> & stack)
+{
+    const std::size_t n = c.diag.size();
+    std::size_t top = n;
+    marks[k] = k;
+    for (std::size_t pos = c.row_starts[k]; pos < c.row_starts[k + 1]; ++pos) {
+        std::size_t len = 0;
+        for (std::uint32_t j = c.cols[pos]; marks[j] != k; j = parent[j]) {
+            stack[len++] = j; // the path is stored at the beginning of the stack, which is free yet
+            marks[j] = k;
+        }
+        while (len > 0) {
+            stack[--top] = stack[--len];
+        }
+    }
+    return top;
+}
+
+} // anonymous namespace
+
+ErrorOr<SparseCholesky> SparseCholesky::factorize(const SparseMatrix & a)
+{
+    if (a.is_diagonal()) {
+        auto diag = a.diag();
+        return factorize_diag(std::vector<double>(diag.data(), diag.data() + diag.dims()));
+    }
+    const std::size_t n = a.dims();
+    if (n >= NO_PARENT) {
+        return "matrix is too large to factorize";
+    }
+
+    SparseCholesky res;
+    res.m_dims = n;
+    res.m_perm = minimum_degree(a);
+    const LowerTriangle c(a, res.m_perm);
+    const auto parent = elimination_tree(c);
+
+    /*
+     * Symbolic factorization: count elements of each column of L, walking patterns of its rows.
+     */
+    std::vector<std::size_t> marks(n, n);
+    std::vector<std::uint32_t> stack(n);
+    std::vector<std::size_t> col_counts(n, 1); // diagonal
+    for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t top = row_pattern(c, k, parent, marks, stack); top < n; ++top) {
+            ++col_counts[stack[top]];
+        }
+    }
+    res.m_col_starts.resize(n + 1);
+    res.m_col_starts[0] = 0;
+    for (std::size_t j = 0; j < n; ++j) {
+        res.m_col_starts[j + 1] = res.m_col_starts[j] + col_counts[j];
+    }
+    res.m_rows.resize(res.m_col_starts[n]);
+    res.m_values.resize(res.m_col_starts[n]);
+
+    /*
+     * Numeric factorization, row k of L is the solution of L[0, k) l_k = c_k, where c_k is row k of the lower triangle.
+     * Row k is appended to the columns of L, which already have all elements above it.
+     */
+    std::fill(marks.begin(), marks.end(), n);
+    std::vector<std::size_t> next(res.m_col_starts.begin(), res.m_col_starts.end() - 1); // where to write in each column
+    std::vector<double> x(n, 0.);
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t top = row_pattern(c, k, parent, marks, stack);
+        for (std::size_t pos = c.row_starts[k]; pos < c.row_starts[k + 1]; ++pos) {
+            x[c.cols[pos]] = c.values[pos];
+        }
+        double d = c.diag[k];
+        for (std::size_t t = top; t < n; ++t) {
+            const std::uint32_t j = stack[t];
+            const std::size_t begin = res.m_col_starts[j];
+            const double l_kj = x[j] / res.m_values[begin];
+            x[j] = 0.;
+            for (std::size_t pos = begin + 1; pos < next[j]; ++pos) {
+                x[res.m_rows[pos]] -= res.m_values[pos] * l_kj;
+            }
+            d -= l_kj * l_kj;
+            res.m_rows[next[j]] = static_cast<std::uint32_t>(k);
+            res.m_values[next[j]++] = l_kj;
+        }
+        if (!(d > 0.)) {
+            return not_positive_definite(res.m_perm[k]);
+        }
+        res.m_rows[next[k]] = static_cast<std::uint32_t>(k);
+        res.m_values[next[k]++] = std::sqrt(d);
+    }
+    return res;
+}
+
+ErrorOr<SparseCholesky> SparseCholesky::factorize(const DiagMatrix & a)
+{
+    return factorize_diag(std::vector<double>(a.diag().begin(), a.diag().end()));
+}
+
+ErrorOr<SparseCholesky> SparseCholesky::factorize_diag(std::vector<double> diag)
+{
+    for (std::size_t i = 0; i < diag.size(); ++i) {
+        if (!(diag[i] > 0.)) {
+            return not_positive_definite(i);
+        }
+    }
+    SparseCholesky res;
+    res.m_dims = diag.size();
+    res.m_values = std::move(diag);
+    return res;
+}
+
+Vector SparseCholesky::solve(const Vector & b) const
+{
+    assert(b.dims() == m_dims && "SparseCholesky dim mismatch");
+    std::vector<double> res(m_dims);
+    if (is_diagonal()) {
+        for (std::size_t i = 0; i < m_dims; ++i) {
+            res[i] = b[i] / m_values[i];
+        }
+        return Vector(std::move(res));
+    }
+
+    std::vector<double> y(m_dims);
+    for (std::size_t k = 0; k < m_dims; ++k) {
+        y[k] = b[m_perm[k]];
+    }
+    /*
+     * L y' = y by columns, then L^T y'' = y' by rows of L^T, which are the same columns.
+     */
+    for (std::size_t j = 0; j < m_dims; ++j) {
+        const std::size_t begin = m_col_starts[j];
+        y[j] /= m_values[begin];
+        for (std::size_t pos = begin + 1; pos < m_col_starts[j + 1]; ++pos) {
+            y[m_rows[pos]] -= m_values[pos] * y[j];
+        }
+    }
+    for (std::size_t j = m_dims; j-- > 0;) {
+        const std::size_t begin = m_col_starts[j];
+        double sum = y[j];
+        for (std::size_t pos = begin + 1; pos < m_col_starts[j + 1]; ++pos) {
+            sum -= m_values[pos] * y[m_rows[pos]];
+        }
+        y[j] = sum / m_values[begin];
+    }
+    for (std::size_t k = 0; k < m_dims; ++k) {
+        res[m_perm[k]] = y[k];
+    }
+    return Vector(std::move(res));
+}
+
+} // namespace util
@@ -0,0 +1,51 @@
+#include "util/ThreadPool.h"
+
+namespace util {
+
+ThreadPool::ThreadPool(std::size_t threads)
+{
+    m_workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_workers.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    for (auto & worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::push(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.emplace_back(std::move(task));
+    }
+    m_cond.notify_one();
+}
+
+void ThreadPool::worker_loop()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cond.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty()) { // m_stop is set and there is nothing left to do
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace util
@@ -0,0 +1,226 @@
+#include "util/Tracing.h"
+
+#include "util/BufferedWriter.h"
+#include "util/Json.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace util {
+
+namespace detail {
+std::atomic<bool> tracing_enabled{false};
+} // namespace detail
+
+namespace {
+
+struct TraceEvent
+{
+    const char * name;
+    std::uint64_t begin; // ticks of trace_clock()
+    std::uint64_t end;
+};
+
+/*
+ * Simultaneous readings of trace_clock() and steady clock: two of them give the length of a tick.
+ */
+struct ClockReading
+{
+    static ClockReading now() noexcept { return {trace_clock(), std::chrono::steady_clock::now()}; }
+
+    /*
+     * Nanoseconds per tick between the readings.
+     */
+    static double ns_per_tick(const ClockReading & from, const ClockReading & to) noexcept
+    {
+        const auto ns = std::chrono::duration<double, std::nano>(to.time - from.time).count();
+        return to.ticks > from.ticks && ns > 0 ? ns / static_cast<double>(to.ticks - from.ticks) : 1.;
+    }
+
+    std::uint64_t ticks;
+    std::chrono::steady_clock::time_point time;
+};
+
+/*
+ * Fixed-size part of a thread's buffer. Only the owner thread writes,
+ * readers see events [0, size) once size is published with release.
+ */
+struct TraceChunk
+{
+    static constexpr std::size_t CAPACITY = 4096;
+
+    TraceEvent events[CAPACITY];
+    std::atomic<std::size_t> size{0};
+    std::atomic<TraceChunk *> next{nullptr};
+};
+
+struct ThreadBuffer
+{
+    explicit ThreadBuffer(std::uint32_t tid)
+        : tid(tid)
+        , head(new TraceChunk)
+        , tail(head)
+    {}
+
+    ~ThreadBuffer()
+    {
+        for (TraceChunk * chunk = head; chunk;) {
+            delete std::exchange(chunk, chunk->next.load());
+        }
+    }
+
+    const std::uint32_t tid;
+    std::string name;   // guarded by Registry::mutex
+    TraceChunk * const head;
+    TraceChunk * tail;  // used by the owner only
+    std::size_t chunks = 1;
+    std::atomic<std::size_t> dropped{0};
+};
+
+struct Registry
+{
+    const ClockReading created = ClockReading::now(); // before any span is recorded, to measure ticks on export
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+/*
+ * Never destroyed, so that threads still running at exit can record safely.
+ */
+Registry & registry()
+{
+    static auto * instance = new Registry;
+    return *instance;
+}
+
+thread_local ThreadBuffer * t_buffer = nullptr;
+
+ThreadBuffer & thread_buffer()
+{
+    if (!t_buffer) {
+        auto & reg = registry();
+        std::lock_guard guard(reg.mutex);
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<std::uint32_t>(reg.buffers.size() + 1)));
+        t_buffer = reg.buffers.back().get();
+    }
+    return *t_buffer;
+}
+
+} // anonymous namespace
+
+void enable_tracing(bool enabled) noexcept
+{
+    detail::tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void record_trace_span(const char * name, std::uint64_t begin, std::uint64_t end) noexcept
+{
+    auto & buf = thread_buffer();
+    TraceChunk * chunk = buf.tail;
+    std::size_t size = chunk->size.load(std::memory_order_relaxed);
+    if (size == TraceChunk::CAPACITY) {
+        if (buf.chunks * TraceChunk::CAPACITY >= MAX_TRACE_EVENTS) {
+            buf.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto * next = new TraceChunk;
+        chunk->next.store(next, std::memory_order_release);
+        buf.tail = chunk = next;
+        buf.chunks++;
+        size = 0;
+    }
+    chunk->events[size] = {name, begin, end};
+    chunk->size.store(size + 1, std::memory_order_release);
+}
+
+void set_trace_thread_name(std::string name)
+{
+    auto & buf = thread_buffer();
+    std::lock_guard guard(registry().mutex);
+    buf.name = std::move(name);
+}
+
+/*
+ * {"traceEvents": [{"name": "solve", "cat": "solver", "ph": "X", "ts": 1.5, "dur": 20.25, "pid": 1, "tid": 1}, ...],
+ *  "displayTimeUnit": "ns"}
+ * Time is in microseconds from the earliest span.
+ */
+std::string chrome_trace_json()
+{
+    auto & reg = registry();
+    std::lock_guard guard(reg.mutex);
+    const double us_per_tick = ClockReading::ns_per_tick(reg.created, ClockReading::now()) / 1000.;
+
+    std::uint64_t origin = UINT64_MAX;
+    for (const auto & buf : reg.buffers) {
+        for (const TraceChunk * chunk = buf->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            const std::size_t size = chunk->size.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < size; ++i) {
+                origin = std::min(origin, chunk->events[i].begin);
+            }
+        }
+    }
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&] {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+    for (const auto & buf : reg.buffers) {
+        const std::string tid = std::to_string(buf->tid);
+        separate();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+        write_json(out, std::string_view(buf->name.empty() ? "thread " + tid : buf->name));
+        if (const auto dropped = buf->dropped.load(std::memory_order_relaxed)) {
+            out += ",\"dropped_spans\":" + std::to_string(dropped);
+        }
+        out += "}}";
+
+        for (const TraceChunk * chunk = buf->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            const std::size_t size = chunk->size.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < size; ++i) {
+                const auto & event = chunk->events[i];
+                separate();
+                out += "{\"name\":";
+                write_json(out, std::string_view(event.name));
+                out += ",\"cat\":\"solver\",\"ph\":\"X\",\"ts\":";
+                write_json(out, static_cast<double>(event.begin - origin) * us_per_tick);
+                out += ",\"dur\":";
+                write_json(out, static_cast<double>(event.end - event.begin) * us_per_tick);
+                out += ",\"pid\":1,\"tid\":" + tid + "}";
+            }
+        }
+    }
+    out += "],\"displayTimeUnit\":\"ns\"}\n";
+    return out;
+}
+
+MaybeErrorText save_chrome_trace(const std::string & path)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return "cannot open '" + path + "': " + std::strerror(errno);
+    }
+    MaybeErrorText err;
+    {
+        BufferedWriter out(fd);
+        out.write(chrome_trace_json());
+        err = out.flush();
+    }
+    ::close(fd);
+    return err;
+}
+
+} // namespace util